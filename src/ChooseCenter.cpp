@@ -10,7 +10,7 @@
  */
 
 #include "ChooseCenter.h"
-#include "Math/Matrix.h"
+#include "Math/Cholesky.h"
 #include <math.h>
 #include <QDomElement>
 #include <QHash>
@@ -697,13 +697,10 @@ bool ChooseCenter::_calPolyCenters()
                     }
                 }
 
-                float stDev;
-                float *stError = new float[n+1];
-                if(!Matrix::lls(n+1,goodVolumes,MM,BB,stDev,currentCoeff,stError)) {
+                if(!Cholesky::lls(n+1,goodVolumes,MM,BB,currentCoeff)) {
                     std::cerr<<"Least Squares Fit Failed in Construct Polynomial"<<std::endl;
                     return false;
                 }
-                delete [] stError;
 
                 //use these coefficient to
                 float errorSum = 0;
@@ -1090,16 +1087,13 @@ bool ChooseCenter::_polyFit(const int nCoeff, const int nData, const float* xDat
     float* b=new float[nData];
     for(int i=0;i<nData;i++)
         b[i]=yData[i];
-    float* stError=new float[nData];
-    float dummyStd;
-    Matrix::lls(nCoeff+1,nData,A,b,dummyStd,aData,stError);
+    Cholesky::lls(nCoeff+1,nData,A,b,aData);
     for(int i=0;i<nData;i++)
         _polyCal(nCoeff,aData,xData[i],b[i]);
     rss =0.0f;
     for(int i=0;i<nData;i++)
         rss +=(b[i]-yData[i])*(b[i]-yData[i]);
 
-    delete[] stError;
     delete[] b;
     for(int i=0;i<=nCoeff;i++)
         delete[] A[i];
@@ -43,7 +43,6 @@ AnalyticGrid::AnalyticGrid()
 
 AnalyticGrid::~AnalyticGrid()
 {
-  delete [] relDist;
   vLat = NULL;
   delete vLat;
   vLon = NULL;
@@ -86,13 +85,13 @@ bool AnalyticGrid::getConfigInfo(Configuration* mainConfig,
   
   QDomElement radar = analyticConfig->getConfig("analytic_radar");
   
-  float* radLocation = getCartesianPoint(rLat,rLon,vLat,vLon);
+  CartesianPoint radLocation = getCartesianPoint(rLat,rLon,vLat,vLon);
 
   //Message::toScreen("vortexLat = "+QString().setNum(*vLat)+" vortexLon = "+QString().setNum(*vLon));
   
   //Message::toScreen("radarLat = "+QString().setNum(*rLat)+" radarLon = "+QString().setNum(*rLon));
   
-  //Message::toScreen("Difference in x = "+QString().setNum(radLocation[0])+" Difference in y = "+QString().setNum(radLocation[1]));
+  //Message::toScreen("Difference in x = "+QString().setNum(radLocation.x)+" Difference in y = "+QString().setNum(radLocation.y));
 
   float rXDistance =  0;
   float rYDistance =  0;
@@ -104,10 +103,10 @@ bool AnalyticGrid::getConfigInfo(Configuration* mainConfig,
 
   // Defines iteration indexes for cappi grid
 
-  xmin = nearbyintf(radLocation[0] - (iDim/2)*iGridsp);
-  xmax = nearbyintf(radLocation[0] + (iDim/2)*iGridsp);
-  ymin = nearbyintf(radLocation[1] - (jDim/2)*jGridsp);
-  ymax = nearbyintf(radLocation[1] + (jDim/2)*jGridsp);
+  xmin = nearbyintf(radLocation.x - (iDim/2)*iGridsp);
+  xmax = nearbyintf(radLocation.x + (iDim/2)*iGridsp);
+  ymin = nearbyintf(radLocation.y - (jDim/2)*jGridsp);
+  ymax = nearbyintf(radLocation.y + (jDim/2)*jGridsp);
   zmin = 1;
   zmax = zmin+kDim*kGridsp;
 
@@ -117,8 +116,7 @@ bool AnalyticGrid::getConfigInfo(Configuration* mainConfig,
     
   centX = iDim/2*iGridsp+xmin;  // x coordinate of storm center on grid
   centY = jDim/2*jGridsp+ymin;  // y coordinate of storm center on grid
-  
-  delete[] radLocation;
+
   
   //testing Message::toScreen("RadX,Y ="+QString().setNum(*rXDistance)+", "+QString().setNum(*rYDistance)+"  VortX,Y ="+QString().setNum(centX)+", "+QString().setNum(centY));
   
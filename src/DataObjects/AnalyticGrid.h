@@ -68,7 +68,6 @@ class AnalyticGrid : public GriddedData
 
   float latReference, lonReference;
   QString outFileName;
-  float* relDist;
 
   float *vLat, *vLon, *rLat, *rLon;
   
@@ -82,10 +82,10 @@ void CappiGrid::gridRadarData(RadarData *radarData, QDomElement cappiConfig,floa
 
     // Defines iteration indexes for cappi grid
 
-    xmin = nearbyintf(relDist[0] - (iDim / 2) * iGridsp);
-    xmax = nearbyintf(relDist[0] + (iDim / 2) * iGridsp);
-    ymin = nearbyintf(relDist[1] - (jDim / 2) * jGridsp);
-    ymax = nearbyintf(relDist[1] + (jDim / 2) * jGridsp);
+    xmin = nearbyintf(relDist.x - (iDim / 2) * iGridsp);
+    xmax = nearbyintf(relDist.x + (iDim / 2) * iGridsp);
+    ymin = nearbyintf(relDist.y - (jDim / 2) * jGridsp);
+    ymax = nearbyintf(relDist.y + (jDim / 2) * jGridsp);
 
     //  Message::toScreen("Xmin = "+QString().setNum(xmin)+" Xmax = "+QString().setNum(xmax)+" Ymin = "+QString().setNum(ymin)+" Ymax = "+QString().setNum(ymax));
 
@@ -95,8 +95,6 @@ void CappiGrid::gridRadarData(RadarData *radarData, QDomElement cappiConfig,floa
     zmin = cappiConfig.firstChildElement("zmin").text().toFloat();;
     zmax = zmin + kDim*kGridsp;
 
-    delete[] relDist;
-
     // Interpolate the data depending on method chosen
     QString interpolation = cappiConfig.firstChildElement("interpolation").text();
     if (interpolation == "cressman") {
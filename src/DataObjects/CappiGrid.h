@@ -45,7 +45,7 @@ private:
     float lonReference;
 
     QString outFileName;
-    float* relDist;
+    CartesianPoint relDist;
 
     class goodRef {
     public:
@@ -10,12 +10,42 @@
 
 #include "Coefficient.h"
 
+static const char* idNames[Coefficient::NUM_IDS] = {
+    "VTC0", "VRC0", "VMC0",
+    "VTC1", "VTS1", "VTC2", "VTS2", "VTC3", "VTS3", "VTC4", "VTS4",
+    "VTC5", "VTS5", "VTC6", "VTS6", "VTC7", "VTS7"
+};
+
+QString Coefficient::parameterName(Id id)
+{
+    if ((id < 0) || (id >= NUM_IDS))
+        return QString("NULL");
+    return QString(idNames[id]);
+}
+
+Coefficient::Id Coefficient::parameterId(const QString &name)
+{
+    for (int i = 0; i < NUM_IDS; i++) {
+        if (name == idNames[i])
+            return Id(i);
+    }
+    return NONE;
+}
+
 Coefficient::Coefficient()
 {
     level = -999;
     radius = -999;
     value = -999;
-    parameter = QString("NULL");
+    id = NONE;
+}
+
+Coefficient::Coefficient(float newLevel, float newRadius, float newValue, Id newId)
+{
+    level = newLevel;
+    radius = newRadius;
+    value = newValue;
+    id = newId;
 }
 
 Coefficient::Coefficient(float newLevel, float newRadius, float newValue,QString name)
@@ -23,7 +53,7 @@ Coefficient::Coefficient(float newLevel, float newRadius, float newValue,QString
     level = newLevel;
     radius = newRadius;
     value = newValue;
-    parameter = name;
+    id = parameterId(name);
 
 }
 
@@ -32,7 +62,7 @@ Coefficient::Coefficient(const Coefficient &other)
     this->level = other.level;
     this->radius = other.radius;
     this->value = other.value;
-    this->parameter = other.parameter;
+    this->id = other.id;
 }
 
 bool Coefficient::isValid() const {
@@ -56,16 +86,21 @@ void Coefficient::setValue(const float &newValue)
     value = newValue;
 }
 
+void Coefficient::setId(const Id &newId)
+{
+    id = newId;
+}
+
 void Coefficient::setParameter(const QString &newParameter)
 {
-    parameter = newParameter;
+    id = parameterId(newParameter);
 }
 
 bool Coefficient::operator == (const Coefficient &other)
 {
     if(level == other.getLevel())
         if(radius == other.getRadius())
-            if(parameter == other.getParameter())
+            if(id == other.getId())
                 if(value == other.getValue())
                     return true;
     return false;
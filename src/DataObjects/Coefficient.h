@@ -17,7 +17,24 @@ class Coefficient
 {
 
 public:
+    // Which wind component this is. The tangential (VT), radial (VR) and
+    // mean (VM) winds of wavenumber n are VTCn/VTSn etc. Names are only
+    // used when reading or writing, the analysis works with these.
+    enum Id {
+        NONE = -1,
+        VTC0 = 0, VRC0, VMC0,
+        VTC1, VTS1, VTC2, VTS2, VTC3, VTS3, VTC4, VTS4,
+        VTC5, VTS5, VTC6, VTS6, VTC7, VTS7,
+        NUM_IDS
+    };
+
+    static Id vtc(int waveNum) { return (waveNum == 0) ? VTC0 : wave(2 * waveNum + 1); }
+    static Id vts(int waveNum) { return (waveNum == 0) ? NONE : wave(2 * waveNum + 2); }
+    static QString parameterName(Id id);
+    static Id parameterId(const QString &name);
+
     Coefficient();
+    Coefficient(float newLevel, float newRadius, float newValue, Id newId);
     Coefficient(float newLevel, float newRadius, float newValue, QString name);
     Coefficient(const Coefficient &other);
 
@@ -32,7 +49,10 @@ public:
     float getValue() const { return value; }
     void setValue(const float &newValue);
 
-    QString getParameter() const { return parameter; }
+    Id getId() const { return id; }
+    void setId(const Id &newId);
+
+    QString getParameter() const { return parameterName(id); }
     void setParameter(const QString &newParameter);
 
     bool operator == (const Coefficient &other);
@@ -41,10 +61,12 @@ public:
 
 
 private:
+    static Id wave(int index) { return (index < NUM_IDS) ? Id(index) : NONE; }
+
     float level;
     float radius;
     float value;
-    QString parameter;
+    Id id;
 
 };
 
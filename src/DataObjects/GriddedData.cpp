@@ -16,6 +16,8 @@
 #include "GriddedData.h"
 #include "IO/Message.h"
 #include <cmath>
+#include <algorithm>
+#include <vector>
 
 GriddedData::GriddedData()
 {
@@ -139,18 +141,17 @@ void GriddedData::setAbsoluteReferencePoint(float Lat, float Lon, float Height)
 
   // This assumes that the originLat and originLon are the radar coordinates.
   
-  float *locations = getCartesianPoint(&originLat, &originLon, &Lat, &Lon);
+  CartesianPoint location = getCartesianPoint(&originLat, &originLon, &Lat, &Lon);
   
     // Floor is used to round to the nearest integer
 
-    refPointI = int(floor((locations[0] - xmin) / iGridsp + .5));
-    refPointJ = int(floor((locations[1] - ymin) / jGridsp + .5));
+    refPointI = int(floor((location.x - xmin) / iGridsp + .5));
+    refPointJ = int(floor((location.y - ymin) / jGridsp + .5));
     refPointK = int(floor((Height - zmin) / kGridsp + .5));
     // testing Message::toScreen("I = "+QString().setNum(refPointI)+" J = "+QString().setNum(refPointJ)+" K = "+QString().setNum(refPointK));
-    delete[] locations;
 }
 
-float* GriddedData::getCartesianPoint(float *Lat, float *Lon, float *relLat, float *relLon)
+CartesianPoint GriddedData::getCartesianPoint(float *Lat, float *Lon, float *relLat, float *relLon)
 {
     // Returns the distance between the two (Lat,Lon) points in km
     // Thanks to Peter Dodge for some code used here
@@ -159,13 +160,10 @@ float* GriddedData::getCartesianPoint(float *Lat, float *Lon, float *relLat, flo
     float fac_lat = 111.13209 - 0.56605 * cos(2.0 * LatRadians) + 0.00012 * cos(4.0 * LatRadians) - 0.000002 * cos(6.0 * LatRadians);
     float fac_lon = 111.41513 * cos(LatRadians) - 0.09455 * cos(3.0 * LatRadians) + 0.00012 * cos(5.0 * LatRadians);
 
-    float relX = (*relLon - *Lon) * fac_lon;
-    float relY = (*relLat - *Lat) * fac_lat;
-
-    float *relArray = new float[2];
-    relArray[0] = relX;
-    relArray[1] = relY;
-    return relArray;
+    CartesianPoint relPoint;
+    relPoint.x = (*relLon - *Lon) * fac_lon;
+    relPoint.y = (*relLat - *Lat) * fac_lat;
+    return relPoint;
 }
 
 float GriddedData::getCartesianDistance(float Lat, float Lon, float relLat, float relLon)
@@ -183,21 +181,21 @@ float GriddedData::getCartesianDistance(float Lat, float Lon, float relLat, floa
     // This value is returned in KM ???? -LM
 }
 
-float* GriddedData::getAdjustedLatLon(const float startLat, const float startLon, const float changeInX, const float changeInY)
+LatLon GriddedData::getAdjustedLatLon(const float startLat, const float startLon, const float changeInX, const float changeInY)
 {
     // This function acts like the inverse of the one above.
     // If it is given an initial latitude and longitude
     // and the cartesian distance change (km) in each direction
-    // it will return a new pair of points {newLat, newLon}
+    // it will return the new point {lat, lon}
 
     float LatRadians = startLat * acos(-1.0)/180.0;
     float fac_lat = 111.13209 - 0.56605 * cos(2.0 * LatRadians)
             + 0.00012 * cos(4.0 * LatRadians) - 0.000002 * cos(6.0 * LatRadians);
     float fac_lon = 111.41513 * cos(LatRadians)
             - 0.09455 * cos(3.0 * LatRadians) + 0.00012 * cos(5.0 * LatRadians);
-    float* newLatLon = new float[2];
-    newLatLon[0] = changeInY/fac_lat +startLat;
-    newLatLon[1] = changeInX/fac_lon +startLon;
+    LatLon newLatLon;
+    newLatLon.lat = changeInY/fac_lat +startLat;
+    newLatLon.lon = changeInX/fac_lon +startLon;
     return newLatLon;
 }
 
@@ -374,113 +372,77 @@ float GriddedData::getIndexValue(QString& fieldName, float& ii, float& jj, float
 
 }
 
-float* GriddedData::getCartesianXslice(const QString& fieldName, 
-                                       const float& y, const float& z)
+SliceView GriddedData::getCartesianXslice(const QString& fieldName, 
+                                          const float& y, const float& z) const
 {
     /*
-   * Returns a list of interpolated vales to match the fieldName,y,z values
-   * given for the entire range x values with the gridded data. The number
-   * of points returned should be equivalent to the dimension in the
-   * unspecified coordinate direction, in this case the x direction.
+   * Returns a view of the fieldName values along the entire x range of the
+   * grid at the grid line closest to (y,z). Nothing is copied, the number
+   * of points in the view is the dimension in the unspecified coordinate
+   * direction, in this case the x direction. An invalid view is returned
+   * if (y,z) is outside of the grid.
    *
    */
 
+    SliceView view = { 0, 0, 0 };
     int field = getFieldIndex(fieldName);
-    float* values = new float[(int)iDim];
-
-    float jjIndex = getIndexFromCartesianPointJ(y);
-    float kkIndex = getIndexFromCartesianPointK(z);
-    int jjMin = int(floor(jjIndex));
-    int jjMax = int(floor(jjIndex)+1);
-    int kkMin = int(floor(kkIndex));
-    int kkMax = int(floor(kkIndex)+1);
-    float jjMinDiff = jjIndex - jjMin;
-    float jjMaxDiff = jjMax - jjIndex;
-    float kkMinDiff = kkIndex - kkMin;
-    float kkMaxDiff = kkMax - kkIndex;
-
-    for(int i = 0; i < iDim; i++) {
-        float ave = 0;
-        ave += (1-jjMaxDiff)*(1-kkMinDiff)*dataGrid[field][i][jjMax][kkMin];
-        ave += (1-jjMinDiff)*(1-kkMinDiff)*dataGrid[field][i][jjMin][kkMin];
-        ave += (1-jjMaxDiff)*(1-kkMaxDiff)*dataGrid[field][i][jjMax][kkMax];
-        ave += (1-jjMinDiff)*(1-kkMaxDiff)*dataGrid[field][i][jjMin][kkMax];
-        values[i] = ave;
-    }
-    return values;
+    int jj = getIndexFromCartesianPointJ(y);
+    int kk = getIndexFromCartesianPointK(z);
+    if((field < 0)||(jj < 0)||(kk < 0))
+        return view;
+
+    view.data = &dataGrid[field][0][jj][kk];
+    view.stride = maxJDim*maxKDim;
+    view.extent = int(iDim);
+    return view;
 }
 
-float* GriddedData::getCartesianYslice(const QString& fieldName,
-                                       const float& x, const float& z)
+SliceView GriddedData::getCartesianYslice(const QString& fieldName,
+                                          const float& x, const float& z) const
 {
     /*
-   * Returns a list of interpolated vales to match the fieldName,x,z values
-   * given for the entire range y values with the gridded data. The number
-   * of points returned should be equivalent to the dimension in the
-   * unspecified coordinate direction, in this case the y direction.
+   * Returns a view of the fieldName values along the entire y range of the
+   * grid at the grid line closest to (x,z). The number of points in the
+   * view is the dimension in the unspecified coordinate direction, in this
+   * case the y direction.
    *
    */
 
+    SliceView view = { 0, 0, 0 };
     int field = getFieldIndex(fieldName);
-    float* values = new float[(int)jDim];
-
-    float iiIndex = getIndexFromCartesianPointI(x);
-    float kkIndex = getIndexFromCartesianPointK(z);
-    int iiMin = int(floor(iiIndex));
-    int iiMax = int(floor(iiIndex)+1);
-    int kkMin = int(floor(kkIndex));
-    int kkMax = int(floor(kkIndex)+1);
-
-    float iiMinDiff = iiIndex - iiMin;
-    float iiMaxDiff = iiMax - iiIndex;
-    float kkMinDiff = kkIndex - kkMin;
-    float kkMaxDiff = kkMax - kkIndex;
-
-    for(int j = 0; j < jDim; j++) {
-        float ave = 0;
-        ave += (1-iiMinDiff)*(1-kkMaxDiff)*dataGrid[field][iiMin][j][kkMax];
-        ave += (1-iiMaxDiff)*(1-kkMaxDiff)*dataGrid[field][iiMax][j][kkMax];
-        ave += (1-iiMinDiff)*(1-kkMinDiff)*dataGrid[field][iiMin][j][kkMin];
-        ave += (1-iiMaxDiff)*(1-kkMinDiff)*dataGrid[field][iiMax][j][kkMin];
-        values[j] = ave;
-    }
-    return values;
+    int ii = getIndexFromCartesianPointI(x);
+    int kk = getIndexFromCartesianPointK(z);
+    if((field < 0)||(ii < 0)||(kk < 0))
+        return view;
+
+    view.data = &dataGrid[field][ii][0][kk];
+    view.stride = maxKDim;
+    view.extent = int(jDim);
+    return view;
 }
 
-float* GriddedData::getCartesianZslice(const QString& fieldName,
-                                       const float& x, const float& y)
+SliceView GriddedData::getCartesianZslice(const QString& fieldName,
+                                          const float& x, const float& y) const
 {
     /*
-   * Returns a list of interpolated vales to match the fieldName,x,y values
-   * given for the entire range z values with the gridded data. The number
-   * of points returned should be equivalent to the dimension in the
-   * unspecified coordinate direction, in this case the z direction.
+   * Returns a view of the fieldName values along the entire z range of the
+   * grid at the grid line closest to (x,y). The number of points in the
+   * view is the dimension in the unspecified coordinate direction, in this
+   * case the z direction.
    *
    */
 
+    SliceView view = { 0, 0, 0 };
     int field = getFieldIndex(fieldName);
-    float* values = new float[(int)kDim];
-
-    float jjIndex = getIndexFromCartesianPointJ(y);
-    float iiIndex = getIndexFromCartesianPointI(x);
-    int jjMin = int(floor(jjIndex));
-    int jjMax = int(floor(jjIndex)+1);
-    int iiMin = int(floor(iiIndex));
-    int iiMax = int(floor(iiIndex)+1);
-    float jjMinDiff = jjIndex - jjMin;
-    float jjMaxDiff = jjMax - jjIndex;
-    float iiMinDiff = iiIndex - iiMin;
-    float iiMaxDiff = iiMax - iiIndex;
-
-    for(int k = 0; k < kDim; k++) {
-        float ave = 0;
-        ave += (1-jjMinDiff)*(1-iiMaxDiff)*dataGrid[field][iiMax][jjMin][k];
-        ave += (1-jjMaxDiff)*(1-iiMaxDiff)*dataGrid[field][iiMax][jjMax][k];
-        ave += (1-jjMinDiff)*(1-iiMinDiff)*dataGrid[field][iiMin][jjMin][k];
-        ave += (1-jjMaxDiff)*(1-iiMinDiff)*dataGrid[field][iiMin][jjMax][k];
-        values[k] = ave;
-    }
-    return values;
+    int ii = getIndexFromCartesianPointI(x);
+    int jj = getIndexFromCartesianPointJ(y);
+    if((field < 0)||(ii < 0)||(jj < 0))
+        return view;
+
+    view.data = &dataGrid[field][ii][jj][0];
+    view.stride = 1;
+    view.extent = int(kDim);
+    return view;
 }
 
 float GriddedData::getCartesianValue(const QString& fieldName, const float& x, 
@@ -525,6 +487,88 @@ float GriddedData::getCartesianValue(const QString& fieldName, const float& x,
 
 }
 
+void GriddedData::getCartesianValues(const int& field, const int& numPoints,
+                                     const float* x, const float* y,
+                                     const float* z, float* values) const
+{
+    /*
+   * Batch version of getCartesianValue. Everything that does not depend on
+   * the point (field lookup, grid geometry, bounds) is worked out once so
+   * the loop body is straight arithmetic on the grid. Unlike the single
+   * point version the indices are fractional, so this is a true trilinear
+   * interpolation. Points outside the grid, or with a missing (-999)
+   * neighbour, are returned as -999.
+   *
+   */
+
+    const float fillValue = -999.;
+    if((field < 0)||(field >= maxFields)) {
+        for(int n = 0; n < numPoints; n++)
+            values[n] = fillValue;
+        return;
+    }
+
+    const float iScale = 1./iGridsp;
+    const float jScale = 1./jGridsp;
+    const float kScale = 1./kGridsp;
+    const float iLast = iDim - 1;
+    const float jLast = jDim - 1;
+    const float kLast = kDim - 1;
+
+    for(int n = 0; n < numPoints; n++) {
+        float iiIndex = (x[n] - xmin)*iScale;
+        float jjIndex = (y[n] - ymin)*jScale;
+        float kkIndex = (z[n] - zmin)*kScale;
+        if((iiIndex < 0)||(iiIndex > iLast)||(jjIndex < 0)||(jjIndex > jLast)
+           ||(kkIndex < 0)||(kkIndex > kLast)) {
+            values[n] = fillValue;
+            continue;
+        }
+
+        // Keep the upper corner inside the grid when sitting on the last index
+        int iiMin = int(iiIndex);
+        int jjMin = int(jjIndex);
+        int kkMin = int(kkIndex);
+        int iiMax = (iiMin < iLast) ? iiMin + 1 : iiMin;
+        int jjMax = (jjMin < jLast) ? jjMin + 1 : jjMin;
+        int kkMax = (kkMin < kLast) ? kkMin + 1 : kkMin;
+        float iiDiff = iiIndex - iiMin;
+        float jjDiff = jjIndex - jjMin;
+        float kkDiff = kkIndex - kkMin;
+
+        float c000 = dataGrid[field][iiMin][jjMin][kkMin];
+        float c100 = dataGrid[field][iiMax][jjMin][kkMin];
+        float c010 = dataGrid[field][iiMin][jjMax][kkMin];
+        float c110 = dataGrid[field][iiMax][jjMax][kkMin];
+        float c001 = dataGrid[field][iiMin][jjMin][kkMax];
+        float c101 = dataGrid[field][iiMax][jjMin][kkMax];
+        float c011 = dataGrid[field][iiMin][jjMax][kkMax];
+        float c111 = dataGrid[field][iiMax][jjMax][kkMax];
+        if((c000 == fillValue)||(c100 == fillValue)||(c010 == fillValue)
+           ||(c110 == fillValue)||(c001 == fillValue)||(c101 == fillValue)
+           ||(c011 == fillValue)||(c111 == fillValue)) {
+            values[n] = fillValue;
+            continue;
+        }
+
+        float c00 = c000 + iiDiff*(c100 - c000);
+        float c10 = c010 + iiDiff*(c110 - c010);
+        float c01 = c001 + iiDiff*(c101 - c001);
+        float c11 = c011 + iiDiff*(c111 - c011);
+        float c0 = c00 + jjDiff*(c10 - c00);
+        float c1 = c01 + jjDiff*(c11 - c01);
+        values[n] = c0 + kkDiff*(c1 - c0);
+    }
+}
+
+void GriddedData::getCartesianValues(const QString& fieldName, const int& numPoints,
+                                     const float* x, const float* y,
+                                     const float* z, float* values) const
+{
+    int field = getFieldIndex(fieldName);
+    getCartesianValues(field, numPoints, x, y, z, values);
+}
+
 int GriddedData::getSphericalRangeLength(float azimuth, float elevation)
 {
     int count = 0;
@@ -618,6 +662,153 @@ float* GriddedData::getSphericalRangePosition(float azimuth, float elevation,
 }
 
 
+int GriddedData::getSphericalRangeGates(const int& field, float azimuth,
+                                        float elevation, float gateSpacing,
+                                        int numGates, float* gateValues,
+                                        float* gateSpread) const
+{
+    /*
+   * Rather than testing every cell in the grid against the beam, as
+   * getSphericalRangeData does, this walks along the beam axis and steps
+   * from each cell straight into the next one it enters (Amanatides & Woo
+   * traversal). The cost is proportional to the number of cells crossed.
+   * The azimuth is in math convention (ccw from east) and both angles are
+   * in degrees. Each cell counts toward a gate in proportion to the
+   * length of beam that lies inside both of them.
+   *
+   */
+
+    const float fillValue = -999.;
+    for(int g = 0; g < numGates; g++) {
+        gateValues[g] = 0;
+        if (gateSpread)
+            gateSpread[g] = 0;
+    }
+    float* weights = new float[numGates];
+    for(int g = 0; g < numGates; g++)
+        weights[g] = 0;
+
+    float maxRange = numGates*gateSpacing;
+    float cosEl = cos(elevation*deg2rad);
+    float dir[3] = { cosEl*float(cos(azimuth*deg2rad)),
+                     cosEl*float(sin(azimuth*deg2rad)),
+                     float(sin(elevation*deg2rad)) };
+    float spacing[3] = { iGridsp, jGridsp, kGridsp };
+    int dims[3] = { int(iDim), int(jDim), int(kDim) };
+    // Work in km with cell n centered on n*spacing
+    float origin[3] = { refPointI*iGridsp, refPointJ*jGridsp, refPointK*kGridsp };
+
+    // Find where the beam enters and leaves the grid
+    float tEnter = 0;
+    float tExit = maxRange;
+    bool hitsGrid = (field >= 0) && (field < maxFields);
+    for(int n = 0; (n < 3) && hitsGrid; n++) {
+        float lower = -0.5*spacing[n];
+        float upper = (dims[n] - 0.5)*spacing[n];
+        if (fabs(dir[n]) < 1.0e-7) {
+            if ((origin[n] < lower) || (origin[n] >= upper))
+                hitsGrid = false;
+            continue;
+        }
+        float t0 = (lower - origin[n])/dir[n];
+        float t1 = (upper - origin[n])/dir[n];
+        if (t0 > t1) {
+            float swap = t0;
+            t0 = t1;
+            t1 = swap;
+        }
+        if (t0 > tEnter)
+            tEnter = t0;
+        if (t1 < tExit)
+            tExit = t1;
+    }
+    if (tEnter >= tExit)
+        hitsGrid = false;
+
+    if (hitsGrid) {
+        // Set up the traversal at the entry point
+        int cell[3], step[3];
+        float tMax[3], tDelta[3];
+        for(int n = 0; n < 3; n++) {
+            float position = origin[n] + tEnter*dir[n];
+            cell[n] = int(floor(position/spacing[n] + .5));
+            if (cell[n] < 0)
+                cell[n] = 0;
+            if (cell[n] > dims[n] - 1)
+                cell[n] = dims[n] - 1;
+            if (dir[n] > 1.0e-7) {
+                step[n] = 1;
+                tMax[n] = ((cell[n] + 0.5)*spacing[n] - origin[n])/dir[n];
+                tDelta[n] = spacing[n]/dir[n];
+            } else if (dir[n] < -1.0e-7) {
+                step[n] = -1;
+                tMax[n] = ((cell[n] - 0.5)*spacing[n] - origin[n])/dir[n];
+                tDelta[n] = -spacing[n]/dir[n];
+            } else {
+                step[n] = 0;
+                tMax[n] = maxRange + 1;
+                tDelta[n] = 0;
+            }
+        }
+
+        float t = tEnter;
+        while (t < tExit) {
+            // The axis whose cell boundary comes up first
+            int axis = 0;
+            if (tMax[1] < tMax[axis])
+                axis = 1;
+            if (tMax[2] < tMax[axis])
+                axis = 2;
+            float tNext = (tMax[axis] < tExit) ? tMax[axis] : tExit;
+
+            float value = dataGrid[field][cell[0]][cell[1]][cell[2]];
+            if (value != fillValue) {
+                // Share the segment [t, tNext] out among the gates it spans
+                float start = t;
+                while (start < tNext) {
+                    int gate = int(start/gateSpacing);
+                    if (gate >= numGates)
+                        break;
+                    float end = (gate + 1)*gateSpacing;
+                    if (end > tNext)
+                        end = tNext;
+                    float length = end - start;
+                    weights[gate] += length;
+                    gateValues[gate] += length*value;
+                    if (gateSpread)
+                        gateSpread[gate] += length*value*value;
+                    start = end;
+                }
+            }
+
+            t = tNext;
+            cell[axis] += step[axis];
+            if ((cell[axis] < 0) || (cell[axis] >= dims[axis]))
+                break;
+            tMax[axis] += tDelta[axis];
+        }
+    }
+
+    int goodGates = 0;
+    for(int g = 0; g < numGates; g++) {
+        if (weights[g] > 0) {
+            float mean = gateValues[g]/weights[g];
+            gateValues[g] = mean;
+            if (gateSpread) {
+                float variance = gateSpread[g]/weights[g] - mean*mean;
+                gateSpread[g] = (variance > 0) ? sqrt(variance) : 0;
+            }
+            goodGates++;
+        } else {
+            gateValues[g] = fillValue;
+            if (gateSpread)
+                gateSpread[g] = fillValue;
+        }
+    }
+    delete[] weights;
+    return goodGates;
+}
+
 int GriddedData::getSphericalAzimuthLength(float range, float elevation)
 {
     int count = 0;
@@ -1307,6 +1498,299 @@ void GriddedData::getCylindricalAzimuthPosition(int numPoints, float radius, flo
     }
 }
 
+void GriddedData::centerToIndex(float x, float y, int& refI, int& refJ) const
+{
+    // Same rounding as setCartesianReferencePoint
+    refI = int(floor((x - xmin)/iGridsp+.5));
+    refJ = int(floor((y - ymin)/jGridsp+.5));
+}
+
+int GriddedData::getCylindricalAnnulusLength(int numRings, const float* radii,
+                                             float height, int* ringLength)
+{
+    return scanCylindricalAnnulus(-1, refPointI, refPointJ, numRings, radii, height,
+                                  ringLength, 0, 0, 0);
+}
+
+void GriddedData::getCylindricalAnnulusData(QString& fieldName, int numRings,
+                                            const float* radii, float height,
+                                            const int* ringOffset, float* values,
+                                            float* positions)
+{
+    int field = getFieldIndex(fieldName);
+    scanCylindricalAnnulus(field, refPointI, refPointJ, numRings, radii, height, 0,
+                           ringOffset, values, positions);
+}
+
+int GriddedData::getCylindricalAnnulusLength(float xCenter, float yCenter, int numRings,
+                                             const float* radii, float height, int* ringLength)
+{
+    int refI, refJ;
+    centerToIndex(xCenter, yCenter, refI, refJ);
+    return scanCylindricalAnnulus(-1, refI, refJ, numRings, radii, height, ringLength, 0, 0, 0);
+}
+
+void GriddedData::getCylindricalAnnulusData(QString& fieldName, float xCenter, float yCenter,
+                                            int numRings, const float* radii, float height,
+                                            const int* ringOffset, float* values,
+                                            float* positions)
+{
+    int field = getFieldIndex(fieldName);
+    int refI, refJ;
+    centerToIndex(xCenter, yCenter, refI, refJ);
+    scanCylindricalAnnulus(field, refI, refJ, numRings, radii, height, 0,
+                           ringOffset, values, positions);
+}
+
+int GriddedData::scanCylindricalAnnulus(int field, float refI, float refJ, int numRings,
+                                        const float* radii, float height, int* ringLength,
+                                        const int* ringOffset, float* values, float* positions)
+{
+    // Counts the cells in each ring when values is null, otherwise fills
+    // values and positions. Uses the same tests as the single ring functions.
+
+    if(numRings <= 0)
+        return 0;
+
+    int* cursor = new int[numRings];
+    for(int n = 0; n < numRings; n++) {
+        cursor[n] = values ? ringOffset[n] : 0;
+    }
+
+    // Box around the outermost ring, 2 is for a little extra :)
+    float radius = radii[numRings - 1];
+    int iLow = int(refI)-int((radius+cylindricalRadiusSpacing)/iGridsp)-2;
+    int iHigh = int(refI) + int((radius+cylindricalRadiusSpacing)/iGridsp) + 2;
+    if(iLow < 0)
+        iLow = 0;
+    if(iHigh > iDim)
+        iHigh = int(iDim);
+    int jLow = int(refJ)-int((radius+cylindricalRadiusSpacing)/jGridsp)-2;
+    int jHigh = int(refJ)+int((radius+cylindricalRadiusSpacing)/jGridsp)+2;
+    if(jLow < 0)
+        jLow = 0;
+    if(jHigh > jDim)
+        jHigh = int(jDim);
+
+    int total = 0;
+    for(int i = iLow; i < iHigh; i ++) {
+        for(int j = jLow; j < jHigh; j ++) {
+            float r = sqrt(iGridsp*iGridsp*(i-refI)*(i-refI)
+                           + jGridsp*jGridsp*(j-refJ)*(j-refJ));
+
+            // Only rings within a spacing of r can hold this cell
+            int first = std::lower_bound(radii, radii + numRings,
+                                         r - cylindricalRadiusSpacing) - radii;
+            if((first >= numRings) || (radii[first] > r + cylindricalRadiusSpacing))
+                continue;
+
+            float azimuth = 0;
+            if(values)
+                azimuth = fixAngle(atan2((j-refJ),(i-refI)))*rad2deg;
+
+            for(int k = 0; k < kDim; k ++) {
+                if((k <= (((height-zmin)/kGridsp)+cylindricalHeightSpacing/2))
+                        && (k > (((height-zmin)/kGridsp)-cylindricalHeightSpacing/2))) {
+                    for(int n = first; n < numRings; n++) {
+                        if(radii[n] > r + cylindricalRadiusSpacing)
+                            break;
+                        if((r <= (radii[n]+cylindricalRadiusSpacing/2.))
+                                && (r > (radii[n]-cylindricalRadiusSpacing/2.))) {
+                            if(values) {
+                                values[cursor[n]] = dataGrid[field][i][j][k];
+                                positions[cursor[n]] = azimuth;
+                            }
+                            cursor[n]++;
+                            total++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if(ringLength) {
+        for(int n = 0; n < numRings; n++)
+            ringLength[n] = cursor[n];
+    }
+    delete[] cursor;
+    return total;
+}
+
+int GriddedData::getCylindricalRingsLength(int numCenters, const float* xCenters,
+                                           const float* yCenters, float radius,
+                                           float height, int* ringLength)
+{
+    return scanCylindricalRings(-1, numCenters, xCenters, yCenters, radius, height,
+                                ringLength, 0, 0, 0);
+}
+
+void GriddedData::getCylindricalRingsData(QString& fieldName, int numCenters,
+                                          const float* xCenters, const float* yCenters,
+                                          float radius, float height, const int* ringOffset,
+                                          float* values, float* positions)
+{
+    int field = getFieldIndex(fieldName);
+    scanCylindricalRings(field, numCenters, xCenters, yCenters, radius, height,
+                         0, ringOffset, values, positions);
+}
+
+int GriddedData::scanCylindricalRings(int field, int numCenters, const float* xCenters,
+                                      const float* yCenters, float radius, float height,
+                                      int* ringLength, const int* ringOffset,
+                                      float* values, float* positions)
+{
+    // Counts the cells in each ring when values is null, otherwise fills
+    // values and positions. The offsets from the reference point are
+    // whole cells, so the distance and azimuth tests come out exactly as
+    // they do in the single ring functions.
+
+    if(numCenters <= 0)
+        return 0;
+
+    // Offsets of the ring's cells from the center, in the order the
+    // single ring functions visit them. 2 is for a little extra :)
+    int iReach = int((radius+cylindricalRadiusSpacing)/iGridsp) + 2;
+    int jReach = int((radius+cylindricalRadiusSpacing)/jGridsp) + 2;
+    std::vector<int> cellI;
+    std::vector<int> cellJ;
+    std::vector<int> cellK;
+    std::vector<float> cellAzimuth;
+    for(int di = -iReach; di < iReach; di ++) {
+        for(int dj = -jReach; dj < jReach; dj ++) {
+            float iDist = float(di);
+            float jDist = float(dj);
+            float r = sqrt(iGridsp*iGridsp*iDist*iDist + jGridsp*jGridsp*jDist*jDist);
+            if((r > (radius+cylindricalRadiusSpacing/2.))
+                    || (r <= (radius-cylindricalRadiusSpacing/2.)))
+                continue;
+            float azimuth = fixAngle(atan2(jDist, iDist))*rad2deg;
+            for(int k = 0; k < kDim; k ++) {
+                if((k <= (((height-zmin)/kGridsp)+cylindricalHeightSpacing/2))
+                        && (k > (((height-zmin)/kGridsp)-cylindricalHeightSpacing/2))) {
+                    cellI.push_back(di);
+                    cellJ.push_back(dj);
+                    cellK.push_back(k);
+                    cellAzimuth.push_back(azimuth);
+                }
+            }
+        }
+    }
+
+    // Shift them to each center, dropping the cells off the grid
+    int numCells = cellI.size();
+    int total = 0;
+    for(int n = 0; n < numCenters; n++) {
+        int refI, refJ;
+        centerToIndex(xCenters[n], yCenters[n], refI, refJ);
+        int count = 0;
+        for(int c = 0; c < numCells; c++) {
+            int i = refI + cellI[c];
+            int j = refJ + cellJ[c];
+            if((i < 0) || (i >= iDim) || (j < 0) || (j >= jDim))
+                continue;
+            if(values) {
+                values[ringOffset[n] + count] = dataGrid[field][i][j][cellK[c]];
+                positions[ringOffset[n] + count] = cellAzimuth[c];
+            }
+            count++;
+        }
+        if(ringLength)
+            ringLength[n] = count;
+        total += count;
+    }
+    return total;
+}
+
+int GriddedData::getCylindricalAzimuthSamples(const int& field, int numSamples,
+                                              float radius, float height,
+                                              float* values, float* azimuths,
+                                              bool* valid) const
+{
+    return sampleCylindricalAzimuth(field, refPointI, refPointJ, numSamples, radius, height,
+                                    values, azimuths, valid);
+}
+
+int GriddedData::getCylindricalAzimuthSamples(const QString& fieldName, float xCenter, float yCenter,
+                                              int numSamples, float radius, float height,
+                                              float* values, float* azimuths,
+                                              bool* valid) const
+{
+    int refI, refJ;
+    centerToIndex(xCenter, yCenter, refI, refJ);
+    int field = getFieldIndex(fieldName);
+    return sampleCylindricalAzimuth(field, refI, refJ, numSamples, radius, height,
+                                    values, azimuths, valid);
+}
+
+int GriddedData::sampleCylindricalAzimuth(const int& field, float refI, float refJ,
+                                          int numSamples, float radius, float height,
+                                          float* values, float* azimuths, bool* valid) const
+{
+    /*
+   * Unlike getCylindricalAzimuthData, which returns whatever grid cells
+   * fall inside the ring, this returns exactly numSamples values at
+   * azimuths 0, 360/numSamples, ... degrees. Each value is a bilinear
+   * interpolation of the four surrounding cells on the level nearest to
+   * height, so the number and placement of the samples do not depend on
+   * the radius or on where the center sits within a grid cell.
+   *
+   */
+
+    const float fillValue = -999.;
+    int goodCount = 0;
+    int kk = int(floor((height - zmin)/kGridsp + .5));
+    bool levelOk = (field >= 0) && (field < maxFields) && (kk >= 0) && (kk < kDim);
+
+    float deltaAngle = 2.*Pi/numSamples;
+    float iRadius = radius/iGridsp;
+    float jRadius = radius/jGridsp;
+    for(int n = 0; n < numSamples; n++) {
+        float angle = n*deltaAngle;
+        azimuths[n] = angle*rad2deg;
+        values[n] = fillValue;
+        if (valid)
+            valid[n] = false;
+        if (!levelOk)
+            continue;
+
+        float iiIndex = refI + iRadius*cos(angle);
+        float jjIndex = refJ + jRadius*sin(angle);
+        if((iiIndex < 0)||(iiIndex > iDim - 1)||(jjIndex < 0)||(jjIndex > jDim - 1))
+            continue;
+
+        int iiMin = int(iiIndex);
+        int jjMin = int(jjIndex);
+        int iiMax = (iiMin < iDim - 1) ? iiMin + 1 : iiMin;
+        int jjMax = (jjMin < jDim - 1) ? jjMin + 1 : jjMin;
+        float c00 = dataGrid[field][iiMin][jjMin][kk];
+        float c10 = dataGrid[field][iiMax][jjMin][kk];
+        float c01 = dataGrid[field][iiMin][jjMax][kk];
+        float c11 = dataGrid[field][iiMax][jjMax][kk];
+        if((c00 == fillValue)||(c10 == fillValue)||(c01 == fillValue)||(c11 == fillValue))
+            continue;
+
+        float iiDiff = iiIndex - iiMin;
+        float jjDiff = jjIndex - jjMin;
+        float c0 = c00 + iiDiff*(c10 - c00);
+        float c1 = c01 + iiDiff*(c11 - c01);
+        values[n] = c0 + jjDiff*(c1 - c0);
+        if (valid)
+            valid[n] = true;
+        goodCount++;
+    }
+    return goodCount;
+}
+
+int GriddedData::getCylindricalAzimuthSamples(const QString& fieldName, int numSamples,
+                                              float radius, float height,
+                                              float* values, float* azimuths,
+                                              bool* valid) const
+{
+    int field = getFieldIndex(fieldName);
+    return getCylindricalAzimuthSamples(field, numSamples, radius, height, values, azimuths, valid);
+}
+
 void GriddedData::getCylindricalAzimuthPositionTest2(int numPoints, float radius, float height, float* positions) 
 {
     //  int numPoints = getCylindricalAzimuthLength(radius, height);
@@ -1547,8 +2031,7 @@ bool GriddedData::test()
         for(int k = 0; k < kDim; k++) {
             QString fieldName("dz");
             Message::toScreen("field Name "+fieldName+" "+QString().setNum(getFieldIndex(fieldName)));
-            float *xValues = new float[int(floor(iDim))];
-            xValues = getCartesianXslice(fieldName,(j+ymin)*jGridsp+.5,(k+zmin)*kGridsp);
+            SliceView xValues = getCartesianXslice(fieldName,(j+ymin)*jGridsp+.5,(k+zmin)*kGridsp);
             for(int i = 0; i < iDim; i++) {
 
                 if(getCartesianValue(fieldName,(i+xmin)*iGridsp,(j+ymin)*jGridsp, (k+zmin)*kGridsp)!=0) {
@@ -1587,8 +2070,7 @@ bool GriddedData::test()
     for(int i = 0; i < iDim; i++) {
         for(int k = 0; k < kDim; k++) {
             QString fieldName("dz");
-            float *yValues = new float[int(floor(jDim))];
-            yValues = getCartesianYslice(fieldName,(i+xmin)*iGridsp,
+            SliceView yValues = getCartesianYslice(fieldName,(i+xmin)*iGridsp,
                                          (k+zmin)*kGridsp);
             for(int j = 0; j < jDim; j++) {
                 if(yValues[j]!=dataGrid[0][i][j][k]) {
@@ -1621,8 +2103,7 @@ bool GriddedData::test()
     for(int i = 0; i < iDim; i++) {
         for(int j = 0; j < jDim; j++) {
             QString fieldName("dz");
-            float *zValues = new float[int(floor(kDim))];
-            zValues= getCartesianZslice(fieldName,(i+xmin)*iGridsp,(j+ymin)*jGridsp);
+            SliceView zValues = getCartesianZslice(fieldName,(i+xmin)*iGridsp,(j+ymin)*jGridsp);
             for(int k = 0; k < kDim; k++) {
                 if(zValues[k]!=dataGrid[0][i][j][k]) {
                     QString message("TEST: Value not what is expected "+fieldName+" x:"+QString().setNum(i)+" y:"+QString().setNum(j)+" z:"+QString().setNum(k)+" value:"+QString().setNum(zValues[k]));
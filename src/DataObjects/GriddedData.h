@@ -16,6 +16,30 @@
 #include <QDomElement>
 #include <QStringList>
 
+// Position in km relative to another (lat, lon) point, x east and y north
+struct CartesianPoint {
+  float x;
+  float y;
+};
+
+// A (latitude, longitude) pair in degrees
+struct LatLon {
+  float lat;
+  float lon;
+};
+
+// Non owning view of one line through the data grid. Element n lives at
+// data[n*stride], it stays valid as long as the GriddedData it came from.
+struct SliceView {
+  const float* data;
+  int stride;
+  int extent;
+
+  const float& operator[](int n) const { return data[n*stride]; }
+  int size() const { return extent; }
+  bool isValid() const { return data != 0; }
+};
+
 class GriddedData 
 {
 
@@ -50,9 +74,9 @@ class GriddedData
   void setCartesianReferencePoint(float ii, float jj, float kk); 
   void setAbsoluteReferencePoint(float Lat, float Lon, float Height);
 
-  static float* getCartesianPoint(float *Lat, float *Lon,float *relLat, float* relLon);
+  static CartesianPoint getCartesianPoint(float *Lat, float *Lon,float *relLat, float* relLon);
   static float  getCartesianDistance(float Lat, float Lon,float relLat, float relLon);
-  static float* getAdjustedLatLon(const float startLat, const float startLon,const float changeInX,const float changeInY);
+  static LatLon getAdjustedLatLon(const float startLat, const float startLon,const float changeInX,const float changeInY);
 
   float getRefPointI();
   float getRefPointJ();
@@ -89,10 +113,18 @@ class GriddedData
 
   /* Needed a reference point before we could redo coordinate systems. -LM */
   // Cartesian Coordinates
-  float* getCartesianXslice(const QString& fieldName, const float& y,const float& z);
-  float* getCartesianYslice(const QString& fieldName, const float& x, const float& z);
-  float* getCartesianZslice(const QString& fieldName, const float& x, const float& y);
+  SliceView getCartesianXslice(const QString& fieldName, const float& y,const float& z) const;
+  SliceView getCartesianYslice(const QString& fieldName, const float& x, const float& z) const;
+  SliceView getCartesianZslice(const QString& fieldName, const float& x, const float& y) const;
   float  getCartesianValue(const QString& fieldName, const float& x,const float& y, const float& z);
+
+  /* Batch trilinear interpolation at numPoints cartesian (km) locations.
+     The field is resolved once by the caller (see getFieldIndex), points
+     outside the grid or next to missing data come back as -999. */
+  void   getCartesianValues(const int& field, const int& numPoints, const float* x,
+                            const float* y, const float* z, float* values) const;
+  void   getCartesianValues(const QString& fieldName, const int& numPoints, const float* x,
+                            const float* y, const float* z, float* values) const;
  
   // Spherical Coordinates
   int    getSphericalRangeLength(float azimuth, float elevation);
@@ -103,6 +135,16 @@ class GriddedData
   float* getSphericalRangePosition(float azimuth, float elevation);
   float* getSphericalRangePosition(float azimuth, float elevation, int numPts);
 
+  /* Marches a beam from the reference point through the grid one cell at
+     a time (3D DDA) and averages the cells it crosses into numGates gates
+     of gateSpacing km, weighted by the path length in each cell. Gates
+     without data are set to -999. gateSpread, if given, gets the spread
+     of the cell values within each gate. Returns the number of gates
+     with data. */
+  int    getSphericalRangeGates(const int& field, float azimuth, float elevation,
+                                float gateSpacing, int numGates,
+                                float* gateValues, float* gateSpread = 0) const;
+
   int    getSphericalAzimuthLength(float range,float elevation);
   float* getSphericalAzimuthData(QString& fieldName, float range,float elevation);
   float* getSphericalAzimuthPosition(float range, float elevation);
@@ -122,6 +164,48 @@ class GriddedData
   int    getCylindricalAzimuthLength(float radius, float height);
   void   getCylindricalAzimuthData(QString& fieldName,int numPoints, float radius, float height, float* values);
   void   getCylindricalAzimuthPosition(int numPoints, float radius, float height, float* positions);
+  /* Resamples the ring about the reference point to numSamples evenly
+     spaced azimuths (degrees, math convention), bilinearly interpolated
+     on the nearest level. Samples that can not be interpolated are set
+     to -999 and flagged false in valid, if given. Returns the number of
+     good samples. */
+  int    getCylindricalAzimuthSamples(const int& field, int numSamples, float radius, float height,
+                                      float* values, float* azimuths, bool* valid = 0) const;
+  int    getCylindricalAzimuthSamples(const QString& fieldName, int numSamples, float radius, float height,
+                                      float* values, float* azimuths, bool* valid = 0) const;
+  /* The same about a center given in km, as for setCartesianReferencePoint,
+     without moving the reference point, so several threads can sample the
+     grid at once. */
+  int    getCylindricalAzimuthSamples(const QString& fieldName, float xCenter, float yCenter,
+                                      int numSamples, float radius, float height,
+                                      float* values, float* azimuths, bool* valid = 0) const;
+  /* Every ring at one height in a single pass over the grid, instead of
+     one pass per ring. radii must be ascending. Ring n gets the same cells,
+     in the same order, as getCylindricalAzimuthData/Position would give it,
+     and is written at ringOffset[n]. */
+  int    getCylindricalAnnulusLength(int numRings, const float* radii, float height, int* ringLength);
+  void   getCylindricalAnnulusData(QString& fieldName, int numRings, const float* radii, float height,
+                                   const int* ringOffset, float* values, float* positions);
+  /* The same about a center given in km, as for setCartesianReferencePoint.
+     The reference point is left alone, so several threads can pull out
+     the rings of different levels at once. */
+  int    getCylindricalAnnulusLength(float xCenter, float yCenter, int numRings, const float* radii,
+                                     float height, int* ringLength);
+  void   getCylindricalAnnulusData(QString& fieldName, float xCenter, float yCenter, int numRings,
+                                   const float* radii, float height, const int* ringOffset,
+                                   float* values, float* positions);
+  /* One ring about each of several centers, given in km as for
+     setCartesianReferencePoint. The reference point is always a whole
+     cell, so the ring's cells are found once and shifted to each center.
+     Ring n gets the same cells, in the same order, as getCylindricalAzimuth-
+     Data/Position about that center, and is written at ringOffset[n].
+     The reference point itself is left alone, so several threads can
+     pull rings out at once. */
+  int    getCylindricalRingsLength(int numCenters, const float* xCenters, const float* yCenters,
+                                   float radius, float height, int* ringLength);
+  void   getCylindricalRingsData(QString& fieldName, int numCenters, const float* xCenters,
+                                 const float* yCenters, float radius, float height,
+                                 const int* ringOffset, float* values, float* positions);
   int    getCylindricalHeightLength(float radius, float height);
   float* getCylindricalHeightData(QString& fieldName, float radius,float height);
   float* getCylindricalHeightPosition(float radius, float height);
@@ -197,6 +281,17 @@ class GriddedData
   int kDisplayIndex;
   
   bool test();
+
+  // Cell of a center given in km, for the explicit center functions
+  void centerToIndex(float x, float y, int& refI, int& refJ) const;
+  int scanCylindricalAnnulus(int field, float refI, float refJ, int numRings, const float* radii,
+                             float height, int* ringLength, const int* ringOffset, float* values, float* positions);
+  int sampleCylindricalAzimuth(const int& field, float refI, float refJ, int numSamples,
+                               float radius, float height, float* values, float* azimuths,
+                               bool* valid) const;
+  int scanCylindricalRings(int field, int numCenters, const float* xCenters, const float* yCenters,
+                           float radius, float height, int* ringLength, const int* ringOffset,
+                           float* values, float* positions);
   
 };
 
@@ -0,0 +1,96 @@
+/*
+ *  RingCache.cpp
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+#include "RingCache.h"
+#include <math.h>
+
+RingCache::RingCache(int maxEntries)
+{
+    _maxEntries = 1;
+    setMaxEntries(maxEntries);
+    _hits = 0;
+    _misses = 0;
+}
+
+RingCache::~RingCache()
+{
+    clear();
+}
+
+void RingCache::clear()
+{
+    while (!_order.isEmpty())
+        removeOldest();
+}
+
+void RingCache::setMaxEntries(int maxEntries)
+{
+    // Always hold on to at least the last ring so that the pointers
+    // handed out by find() stay valid while they are being used
+    _maxEntries = (maxEntries < 1) ? 1 : maxEntries;
+    while (_order.size() > _maxEntries)
+        removeOldest();
+}
+
+bool RingCache::find(int refI, int refJ, float radius, float height,
+                     int& numData, float*& ringData, float*& ringAzimuths)
+{
+    QHash<quint64, Ring>::const_iterator it = _rings.constFind(makeKey(refI, refJ, radius, height));
+    if (it == _rings.constEnd()) {
+        _misses++;
+        return false;
+    }
+    _hits++;
+    numData = it.value().numData;
+    ringData = it.value().data;
+    ringAzimuths = it.value().azimuths;
+    return true;
+}
+
+void RingCache::insert(int refI, int refJ, float radius, float height,
+                       int numData, float* ringData, float* ringAzimuths)
+{
+    quint64 key = makeKey(refI, refJ, radius, height);
+    if (_rings.contains(key)) {
+        // Already there, keep the old copy
+        delete[] ringData;
+        delete[] ringAzimuths;
+        return;
+    }
+    while (_order.size() >= _maxEntries)
+        removeOldest();
+
+    Ring ring;
+    ring.numData = numData;
+    ring.data = ringData;
+    ring.azimuths = ringAzimuths;
+    _rings.insert(key, ring);
+    _order.enqueue(key);
+}
+
+quint64 RingCache::makeKey(int refI, int refJ, float radius, float height)
+{
+    // refI and refJ are the center in whole km from the radar, as
+    // SimplexThread truncates it, and may be negative. Their low 16 bits
+    // keep them apart for |km| < 32768. Radius and height are kept to
+    // 0.01 km
+    quint64 ring = quint64(floor(radius*100. + .5)) & 0xffff;
+    quint64 level = quint64(floor(height*100. + .5)) & 0xffff;
+    return (quint64(refI & 0xffff) << 48) | (quint64(refJ & 0xffff) << 32)
+        | (ring << 16) | level;
+}
+
+void RingCache::removeOldest()
+{
+    quint64 key = _order.dequeue();
+    Ring ring = _rings.value(key);
+    delete[] ring.data;
+    delete[] ring.azimuths;
+    _rings.remove(key);
+}
@@ -0,0 +1,61 @@
+/*
+ *  RingCache.h
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+#ifndef RINGCACHE_H
+#define RINGCACHE_H
+
+#include <QHash>
+#include <QQueue>
+
+// Keeps the rings extracted from a GriddedData object so that a ring
+// about the same grid point is only pulled out of the grid once. Rings
+// are keyed on the center in whole km (refI, refJ), the radius and the
+// height, the oldest entry is dropped once maxEntries is reached.
+
+class RingCache
+{
+public:
+    RingCache(int maxEntries = 4096);
+    ~RingCache();
+
+    void clear();
+    void setMaxEntries(int maxEntries);
+    int  getMaxEntries() const { return _maxEntries; }
+
+    // On a hit the arrays stay owned by the cache, they remain valid
+    // until the next insert() or clear()
+    bool find(int refI, int refJ, float radius, float height,
+              int& numData, float*& ringData, float*& ringAzimuths);
+    // Takes ownership of ringData and ringAzimuths
+    void insert(int refI, int refJ, float radius, float height,
+                int numData, float* ringData, float* ringAzimuths);
+
+    int  getHits() const   { return _hits; }
+    int  getMisses() const { return _misses; }
+    void resetCounters()   { _hits = _misses = 0; }
+
+private:
+    class Ring {
+    public:
+        int numData;
+        float* data;
+        float* azimuths;
+    };
+
+    int _maxEntries;
+    int _hits;
+    int _misses;
+    QHash<quint64, Ring> _rings;
+    QQueue<quint64> _order;
+
+    static quint64 makeKey(int refI, int refJ, float radius, float height);
+    void removeOldest();
+};
+
+#endif
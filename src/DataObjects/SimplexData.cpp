@@ -16,60 +16,23 @@ constexpr float SimplexData::_fillv;
 
 SimplexData::SimplexData()
 {
-    numLevels = MAXLEVELS;
-    numRadii = MAXRADII;
-    numCenters = MAXCENTERS;
+    numLevels = 0;
+    numRadii = 0;
+    numCenters = 0;
     numPointsUsed = 0;
 
-    for(int i = 0; i < numLevels; i++)
-    {
-        //height[i] = velNull;
-        for(int j = 0; j < numRadii; j++) {
-            meanX[i][j] = _fillv;
-            meanY[i][j] = _fillv;
-            centerStdDeviation[i][j] = _fillv;
-            meanVT[i][j] = _fillv;
-            meanVTUncertainty[i][j] = _fillv;
-            numConvergingCenters[i][j] = (int)_fillv;
-            radius[j] = _fillv;
-            for(int k = 0; k < numCenters; k++) {
-                centers[i][j][k] = Center();
-                initialX[i][j][k] = _fillv;
-                initialY[i][j][k] = _fillv;
-            }
-        }
-    }
-
     time = QDateTime();
 
 }
 
 SimplexData::SimplexData(int availLevels, int availRadii, int availCenters)
 {
-  numLevels = availLevels;        // TODO numLevels could be larger than MAXLEVELS
-  numRadii = availRadii;
-  numCenters = availCenters;
+  numLevels = 0;
+  numRadii = 0;
+  numCenters = 0;
   numPointsUsed = 0;
 
-  for(int i = 0; i < numLevels; i++)
-    {
-      height[i] = _fillv;
-      for(int j = 0; j < numRadii; j++)
-        {
-	  meanX[i][j] = _fillv;
-	  meanY[i][j] = _fillv;
-	  centerStdDeviation[i][j] = _fillv;
-	  meanVT[i][j] = _fillv;
-	  meanVTUncertainty[i][j] = _fillv;
-	  numConvergingCenters[i][j]= int(_fillv);
-	  radius[j] = _fillv;
-	  for(int k = 0; k < numCenters; k++) {
-	    centers[i][j][k] = Center();
-	    initialX[i][j][k] = _fillv;
-	    initialY[i][j][k] = _fillv;
-	  }
-        }
-    }
+  resize(availLevels, availRadii, availCenters);
 
   time = QDateTime();
 }
@@ -81,25 +44,18 @@ SimplexData::SimplexData(const SimplexData& other)
     this->numCenters = other.numCenters;
     this->numPointsUsed = other.numPointsUsed;
 
-    for(int i = 0; i < this->numLevels; i++)
-    {
-        this->height[i] = other.height[i];
-        for(int j = 0; j < this->numRadii; j++)
-        {
-            this->meanX[i][j] = other.meanX[i][j];
-            this->meanY[i][j] = other.meanY[i][j];
-            this->centerStdDeviation[i][j] = other.centerStdDeviation[i][j];
-            this->meanVT[i][j] = other.meanVT[i][j];
-            this->meanVTUncertainty[i][j] = other.meanVTUncertainty[i][j];
-            this->numConvergingCenters[i][j]= other.numConvergingCenters[i][j];
-            this->radius[j] = other.radius[j];
-            for(int k = 0; k < this->numCenters; k++) {
-                this->centers[i][j][k] = other.centers[i][j][k];
-                initialX[i][j][k] = other.initialX[i][j][k];
-                initialY[i][j][k] = other.initialY[i][j][k];
-            }
-        }
-    }
+    this->height = other.height;
+    this->radius = other.radius;
+    this->meanX = other.meanX;
+    this->meanY = other.meanY;
+    this->centerStdDeviation = other.centerStdDeviation;
+    this->meanVT = other.meanVT;
+    this->meanVTUncertainty = other.meanVTUncertainty;
+    this->numConvergingCenters = other.numConvergingCenters;
+    this->budgetExceeded = other.budgetExceeded;
+    this->centers = other.centers;
+    this->initialX = other.initialX;
+    this->initialY = other.initialY;
 
     this->time = other.time;
 }
@@ -111,15 +67,15 @@ SimplexData::~SimplexData()
 float SimplexData::getMeanX(const int& lev, const int& rad) const
 {
     if ((lev < numLevels)&&(rad<numRadii))
-        return meanX[lev][rad];
+        return meanX[ringIndex(lev, rad)];
     Message::toScreen("SimplexData: getX: Outside Bounds");
-    return meanX[0][0];
+    return _fillv;
 }
 
 void SimplexData::setMeanX(const int& lev, const int& rad, const float& newX)
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        meanX[lev][rad] = newX;
+        meanX[ringIndex(lev, rad)] = newX;
     else
         Message::toScreen("SimplexData: setX: Outside Bounds");
 }
@@ -128,22 +84,22 @@ void SimplexData::setMeanX(const float** a, const int& numLev, const int& numRad
 {
     for (int i = 0; i < numLev; i++)
         for(int j = 0; j < numRad; j++)
-            meanX[i][j] = a[i][j];
+            meanX[ringIndex(i, j)] = a[i][j];
 }
 
 float SimplexData::getMeanY(const int& lev, const int& rad) const
 {
     if ((lev < numLevels) && (rad < numRadii))
-        return meanY[lev][rad];
+        return meanY[ringIndex(lev, rad)];
     Message::toScreen("SimplexData: getY: Outside Bounds: Level = "+QString().setNum(lev) +
 		      " Radius = " + QString().setNum(rad));
-    return meanY[0][0];
+    return _fillv;
 }
 
 void SimplexData::setMeanY(const int& lev, const int& rad, const float& newY)
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        meanY[lev][rad] = newY;
+        meanY[ringIndex(lev, rad)] = newY;
     else
         Message::toScreen("SimplexData: setX: Outside Bounds");
 }
@@ -152,22 +108,22 @@ void SimplexData::setMeanY(const float** a, const int& numLev, const int& numRad
 {
     for (int i = 0; i < numLev; i++)
         for(int j = 0; j < numRad; j++)
-            meanY[i][j] = a[i][j];
+            meanY[ringIndex(i, j)] = a[i][j];
 }
 
 float SimplexData::getCenterStdDev(const int& lev, const int& rad) const
 {
     if((lev < numLevels)&&(rad < numRadii))
-        return centerStdDeviation[lev][rad];
+        return centerStdDeviation[ringIndex(lev, rad)];
     Message::toScreen("SimplexData: getCenterStdDev: Outside Bounds");
-    return centerStdDeviation[0][0];
+    return _fillv;
 }
 
 void SimplexData::setCenterStdDev(const int& lev, const int& rad,
                                   const float& number)
 {
     if((lev < numLevels)&&(rad < numRadii))
-        centerStdDeviation[lev][rad] = number;
+        centerStdDeviation[ringIndex(lev, rad)] = number;
     else
         Message::toScreen("SimplexData: setCenterStdDev: Outside Bounds");
 }
@@ -177,7 +133,7 @@ void SimplexData::setCenterStdDev(const float** a, const int& numLev,
 {
     for(int i = 0; i < numLev; i++)
         for(int j = 0; j < numRad; j++)
-            centerStdDeviation[i][j]=a[i][j];
+            centerStdDeviation[ringIndex(i, j)]=a[i][j];
 }
 
 float SimplexData::getHeight(const int& i) const
@@ -185,7 +141,7 @@ float SimplexData::getHeight(const int& i) const
     if (i < numLevels)
         return height[i];
     Message::toScreen("SimplexData: getHeight: Outside Bounds");
-    return height[0];
+    return _fillv;
 }
 
 
@@ -208,7 +164,7 @@ float SimplexData::getRadius(const int& i) const
     if (i < numRadii)
         return radius[i];
     Message::toScreen("SimplexData: getRadius: Outside Bounds");
-    return radius[0];
+    return _fillv;
 }
 
 
@@ -239,15 +195,15 @@ void SimplexData::setTime(const QDateTime& radarTime)
 float SimplexData::getMaxVT(const int& lev, const int& rad) const
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        return meanVT[lev][rad];
+        return meanVT[ringIndex(lev, rad)];
     Message::toScreen("SimplexData: getMaxVT: Outside Bounds");
-    return meanVT[0][0];
+    return _fillv;
 }
 
 void SimplexData::setMaxVT(const int& lev, const int& rad, const float& vel)
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        meanVT[lev][rad] = vel;
+        meanVT[ringIndex(lev, rad)] = vel;
     else
         Message::toScreen("SimplexData: setMaxVT: Outside Bounds");
 }
@@ -257,22 +213,22 @@ void SimplexData::setMaxVT(const float** a, const int& numLev,
 {
     for ( int i = 0; i < numLev; i++)
         for(int j = 0; j < numRad; j++)
-            meanVT[i][j] = a[i][j];
+            meanVT[ringIndex(i, j)] = a[i][j];
 }
 
 float SimplexData::getVTUncertainty(const int& lev, const int& rad) const
 {
     if((lev < numLevels)&&(rad < numRadii))
-        return meanVTUncertainty[lev][rad];
+        return meanVTUncertainty[ringIndex(lev, rad)];
     Message::toScreen("SimplexData: getVTUncertainty: Outside Bounds");
-    return meanVTUncertainty[0][0];
+    return _fillv;
 }
 
 void SimplexData::setVTUncertainty(const int& lev, const int& rad, 
                                    const float& dMaxVT)
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        meanVTUncertainty[lev][rad] = dMaxVT;
+        meanVTUncertainty[ringIndex(lev, rad)] = dMaxVT;
     else
         Message::toScreen("SimplexData: setVTUncertainty: Outside Bounds");
 }
@@ -282,23 +238,23 @@ void SimplexData::setVTUncertainty(const float** a, const int& numLev,
 {
     for (int i = 0; i < numLev; i++)
         for (int j = 0; j < numRad; j++)
-            meanVTUncertainty[i][j] = a[i][j];
+            meanVTUncertainty[ringIndex(i, j)] = a[i][j];
 }
 
 int SimplexData::getNumConvergingCenters(const int& lev, const int& rad) const
 {
     if((lev < numLevels) && (rad < numRadii))
-        return numConvergingCenters[lev][rad];
+        return numConvergingCenters[ringIndex(lev, rad)];
     Message::toScreen("SimplexData: getNumConvergingCenters: Outside Bounds Level = " + QString().setNum(lev)
 		      + " radius = " + QString().setNum(rad));
-    return numConvergingCenters[0][0];
+    return (int)_fillv;
 }
 
 void SimplexData::setNumConvergingCenters(const int& lev, const int& rad, 
                                           const int& num)
 {
-    if((lev < numLevels)&&(rad < numRadii)&&(num < numPointsUsed)) {
-        numConvergingCenters[lev][rad] = num;
+    if((lev < numLevels)&&(rad < numRadii)&&(num <= numPointsUsed)) {
+        numConvergingCenters[ringIndex(lev, rad)] = num;
         return;
     }
 
@@ -312,14 +268,31 @@ void SimplexData::setNumConvergingCenters(const int** a, const int& numLev,
 {
     for (int i = 0; i < numLev; i++)
         for (int j = 0; j < numRad; j++)
-            numConvergingCenters[i][j] = a[i][j];
+            numConvergingCenters[ringIndex(i, j)] = a[i][j];
+}
+
+bool SimplexData::getBudgetExceeded(const int& lev, const int& rad) const
+{
+    if((lev < numLevels) && (rad < numRadii))
+        return budgetExceeded[ringIndex(lev, rad)];
+    Message::toScreen("SimplexData: getBudgetExceeded: Outside Bounds");
+    return false;
+}
+
+void SimplexData::setBudgetExceeded(const int& lev, const int& rad,
+                                    const bool& exceeded)
+{
+    if((lev < numLevels) && (rad < numRadii))
+        budgetExceeded[ringIndex(lev, rad)] = exceeded;
+    else
+        Message::toScreen("SimplexData: setBudgetExceeded: Outside Bounds");
 }
 
 Center SimplexData::getCenter(const int& lev, const int& rad, 
                               const int& waveNum) const
 {
     if((lev < numLevels)&&(rad < numRadii)&&(waveNum < numCenters))
-        return centers[lev][rad][waveNum];
+        return centers[centerIndex(lev, rad, waveNum)];
     Message::toScreen("SimplexData: getCenter: Outside Bounds");
     return Center();
 }
@@ -327,7 +300,10 @@ Center SimplexData::getCenter(const int& lev, const int& rad,
 void SimplexData::setCenter(const int& lev, const int& rad, 
                             const int& waveNum, const Center &newCenter)
 {
-    centers[lev][rad][waveNum] = newCenter;
+    if((lev < numLevels)&&(rad < numRadii)&&(waveNum < numCenters))
+        centers[centerIndex(lev, rad, waveNum)] = newCenter;
+    else
+        Message::toScreen("SimplexData: setCenter: Outside Bounds");
 }
 
 int SimplexData::getNumPointsUsed() const
@@ -364,13 +340,15 @@ bool SimplexData::operator > (const SimplexData &other)
 bool SimplexData::isNull()
 {
     if(time.isNull()) {
-        if(meanX[0][0] == _fillv)
-            if(meanY[0][0] == _fillv)
-                if(height[0]== _fillv)
-                    if(radius[0] == _fillv)
-                        if(meanVT[0][0] == _fillv)
-                            if(numConvergingCenters[0][0]==(int)_fillv)
-                                if(centers[0][0][0].isValid())
+        if((numLevels == 0) || (numRadii == 0) || (numCenters == 0))
+            return true;
+        if(meanX.at(0) == _fillv)
+            if(meanY.at(0) == _fillv)
+                if(height.at(0)== _fillv)
+                    if(radius.at(0) == _fillv)
+                        if(meanVT.at(0) == _fillv)
+                            if(numConvergingCenters.at(0)==(int)_fillv)
+                                if(centers.at(0).isValid())
                                     return true;
     }
     return false;
@@ -379,10 +357,10 @@ bool SimplexData::isNull()
 bool SimplexData::emptyLevelRadius(const int& l, const int& r) const 
 {
     if((l < numLevels)&&(r < numRadii)){
-        if((meanX[l][r]==_fillv)||(meanY[l][r]==_fillv)
-                ||(centerStdDeviation[l][r]==_fillv)
-                ||(numConvergingCenters[l][r]==(int)_fillv)||(meanVT[l][r]==_fillv)
-                ||(meanVTUncertainty[l][r]==_fillv))
+        if((meanX[ringIndex(l, r)]==_fillv)||(meanY[ringIndex(l, r)]==_fillv)
+                ||(centerStdDeviation[ringIndex(l, r)]==_fillv)
+                ||(numConvergingCenters[ringIndex(l, r)]==(int)_fillv)||(meanVT[ringIndex(l, r)]==_fillv)
+                ||(meanVTUncertainty[ringIndex(l, r)]==_fillv))
             return true;
         return false;
     }
@@ -417,39 +395,98 @@ void SimplexData::printString()
 
 void SimplexData::setNumLevels(int newNumLevels)
 {
-    this->numLevels = newNumLevels;
+    resize(newNumLevels, numRadii, numCenters);
 }
 
 void SimplexData::setNumRadii(int newNumRadii)
 {
-    this->numRadii = newNumRadii;
+    resize(numLevels, newNumRadii, numCenters);
 }
 
 void SimplexData::setNumCenters(int newNumCenters) 
 {
-    this->numCenters = newNumCenters;
+    resize(numLevels, numRadii, newNumCenters);
+}
+
+void SimplexData::resize(int newNumLevels, int newNumRadii, int newNumCenters)
+{
+    // Anything already set is kept, the new entries are filled
+    if (newNumLevels < 0) newNumLevels = 0;
+    if (newNumRadii < 0) newNumRadii = 0;
+    if (newNumCenters < 0) newNumCenters = 0;
+
+    int numRings = newNumLevels * newNumRadii;
+    int numAll = numRings * newNumCenters;
+    QVector<float> newMeanX(numRings, _fillv), newMeanY(numRings, _fillv);
+    QVector<float> newStdDev(numRings, _fillv);
+    QVector<float> newMeanVT(numRings, _fillv), newMeanVTUncertainty(numRings, _fillv);
+    QVector<int>   newConverging(numRings, (int)_fillv);
+    QVector<bool>  newBudgetExceeded(numRings, false);
+    QVector<Center> newCenters(numAll);
+    QVector<float> newInitialX(numAll, _fillv), newInitialY(numAll, _fillv);
+
+    for (int i = 0; (i < numLevels) && (i < newNumLevels); i++) {
+        for (int j = 0; (j < numRadii) && (j < newNumRadii); j++) {
+            int from = ringIndex(i, j);
+            int to = i * newNumRadii + j;
+            newMeanX[to] = meanX[from];
+            newMeanY[to] = meanY[from];
+            newStdDev[to] = centerStdDeviation[from];
+            newMeanVT[to] = meanVT[from];
+            newMeanVTUncertainty[to] = meanVTUncertainty[from];
+            newConverging[to] = numConvergingCenters[from];
+            newBudgetExceeded[to] = budgetExceeded[from];
+            for (int k = 0; (k < numCenters) && (k < newNumCenters); k++) {
+                newCenters[to * newNumCenters + k] = centers[centerIndex(i, j, k)];
+                newInitialX[to * newNumCenters + k] = initialX[centerIndex(i, j, k)];
+                newInitialY[to * newNumCenters + k] = initialY[centerIndex(i, j, k)];
+            }
+        }
+    }
+
+    height.resize(newNumLevels);
+    for (int i = numLevels; i < newNumLevels; i++)
+        height[i] = _fillv;
+    radius.resize(newNumRadii);
+    for (int j = numRadii; j < newNumRadii; j++)
+        radius[j] = _fillv;
+
+    meanX = newMeanX;
+    meanY = newMeanY;
+    centerStdDeviation = newStdDev;
+    meanVT = newMeanVT;
+    meanVTUncertainty = newMeanVTUncertainty;
+    numConvergingCenters = newConverging;
+    budgetExceeded = newBudgetExceeded;
+    centers = newCenters;
+    initialX = newInitialX;
+    initialY = newInitialY;
+
+    numLevels = newNumLevels;
+    numRadii = newNumRadii;
+    numCenters = newNumCenters;
 }
 
 float SimplexData::getInitialX(const int& level, const int& rad, 
                                const int& center) const
 {
-    return initialX[level][rad][center];
+    return initialX[centerIndex(level, rad, center)];
 }
 
 float SimplexData::getInitialY(const int& level, const int& rad, 
                                const int& center) const
 {
-    return initialY[level][rad][center];
+    return initialY[centerIndex(level, rad, center)];
 }
 
 void SimplexData::setInitialX( int& level,  int& rad, 
                                int& center,  float& value)
 {
-    initialX[level][rad][center] = value;
+    initialX[centerIndex(level, rad, center)] = value;
 }
 
 void SimplexData::setInitialY( int& level,  int& rad, 
                                int& center,  float& value)
 {
-    initialY[level][rad][center] = value;
+    initialY[centerIndex(level, rad, center)] = value;
 }
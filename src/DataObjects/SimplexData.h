@@ -13,6 +13,7 @@
 
 #include "Center.h"
 #include <QDateTime>
+#include <QVector>
 
 class SimplexData
 {
@@ -62,6 +63,10 @@ public:
     void setNumConvergingCenters(const int** a, const int& numLev,
                                  const int& numRad);
 
+    // Whether the searches of a ring were cut short by the time budget
+    bool getBudgetExceeded(const int& lev, const int& rad) const;
+    void setBudgetExceeded(const int& lev, const int& rad, const bool& exceeded);
+
     Center getCenter(const int& lev, const int& rad, const int& centers) const;
     void   setCenter(const int& lev, const int& rad, const int& center, const Center &newCenter);
 
@@ -76,10 +81,6 @@ public:
     int getNumRadii() const { return numRadii; }
     int getNumCenters() const { return numCenters; }
 
-    static int getMaxLevels() { return MAXLEVELS; }
-    static int getMaxRadii() { return MAXRADII; }
-    static int getMaxCenters() { return MAXCENTERS; }
-
     void setNumLevels(int newNumLevels);
     void setNumRadii(int newNumRadii);
     void setNumCenters(int newNumCenters);
@@ -96,10 +97,9 @@ public:
     void printString();
 
 private:
-    // static const int MAXLEVELS  = 15;
-    static const int MAXLEVELS  = 25;
-    static const int MAXRADII   = 31;
-    static const int MAXCENTERS = 25;
+    // Sized from the simplex configuration. The containers are implicitly
+    // shared, so copies made by SimplexList cost nothing until one of
+    // them is changed.
 
     int numLevels;
     int numRadii;
@@ -107,28 +107,34 @@ private:
 
     int numPointsUsed;
 
-    float initialX[MAXLEVELS][MAXRADII][MAXCENTERS];
-    float initialY[MAXLEVELS][MAXRADII][MAXCENTERS];
+    void resize(int newNumLevels, int newNumRadii, int newNumCenters);
+    int ringIndex(const int& lev, const int& rad) const { return lev * numRadii + rad; }
+    int centerIndex(const int& lev, const int& rad, const int& center) const
+    { return (lev * numRadii + rad) * numCenters + center; }
+
+    QVector<float> initialX;
+    QVector<float> initialY;
 
-    float meanX[MAXLEVELS][MAXRADII];
-    float meanY[MAXLEVELS][MAXRADII];
+    QVector<float> meanX;
+    QVector<float> meanY;
 
-    float height[MAXLEVELS];
-    float radius[MAXRADII];
+    QVector<float> height;
+    QVector<float> radius;
     // These two members hold absolute values of the distances the represent
     // since the area of interest might have non-interger units, or be offset
     // physically while still occupying the lowest index
 
-    float centerStdDeviation[MAXLEVELS][MAXRADII];
+    QVector<float> centerStdDeviation;
 
-    int numConvergingCenters[MAXLEVELS][MAXRADII];
+    QVector<int> numConvergingCenters;
+    QVector<bool> budgetExceeded;
 
     QDateTime time;
 
-    float meanVT[MAXLEVELS][MAXRADII];
-    float meanVTUncertainty[MAXLEVELS][MAXRADII];
+    QVector<float> meanVT;
+    QVector<float> meanVTUncertainty;
 
-    Center centers[MAXLEVELS][MAXRADII][MAXCENTERS];
+    QVector<Center> centers;
 
 };
 
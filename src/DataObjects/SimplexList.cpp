@@ -51,6 +51,8 @@ bool SimplexList::saveXML()
             for(int ridx=0;ridx<record->getNumRadii();ridx++){
                 xmlWriter.writeStartElement("ring");
                 xmlWriter.writeAttribute("range",QString().setNum(record->getRadius(ridx)));
+                if(record->getBudgetExceeded(hidx, ridx))
+                    xmlWriter.writeAttribute("budgetexceeded","true");
                 tmpStr.sprintf("%6.2f,%6.2f,%6.2f,%6.2f", record->getMeanX(hidx, ridx),
 			       record->getMeanY(hidx, ridx), record->getCenterStdDev(hidx, ridx),
                                record->getMaxVT(hidx, ridx) // , record->getVTUncertainty(hidx, ridx)
@@ -92,8 +92,8 @@ VortexData::VortexData(const VortexData &other)
         this->_RMWUncertainty[i] = other._RMWUncertainty[i];
         this->_centerSD[i] = other._centerSD[i];
         for(int j = 0; j < _numRadii; j++) {
-            for(int k = 0; k < _numWaveNum; k++) {
-                this->coefficients[i][j][k] = coefficients[i][j][k];
+            for(int k = 0; k < MAXCOEFFS; k++) {
+                this->coefficients[i][j][k] = other.coefficients[i][j][k];
             }
         }
     }
@@ -143,39 +143,34 @@ int VortexData::getHeightIndex(const float& height) const
     return closestIndex;
 }
 
-Coefficient VortexData::getCoefficient(const int& lev, const int& rad, 
-                                       const int& waveNum) const
-{
-    return coefficients[lev][rad][waveNum];
-}
-
 Coefficient VortexData::getCoefficient(const int& lev, const int& rad,
-                                       const QString& parameter) const
+                                       const Coefficient::Id& id) const
 {
-    for(int i = 0; i < _numWaveNum; i++) {
-        if(coefficients[lev][rad][i].getParameter() == parameter)
-            return coefficients[lev][rad][i];
-    }
-    return Coefficient();
+    if((id < 0) || (id >= MAXCOEFFS))
+        return Coefficient();
+    // Only return it if that slot has actually been filled
+    if(coefficients[lev][rad][id].getId() != id)
+        return Coefficient();
+    return coefficients[lev][rad][id];
 }
 
 Coefficient VortexData::getCoefficient(const float& height, const int& rad,
-                                       const QString& parameter) const
+                                       const Coefficient::Id& id) const
 {
     int level = getHeightIndex(height);
     if((level == -1) || (rad == -1)) {
         Message::toScreen("VortexData: GetCoefficient(3): Can't Get Needed Indices");
         return Coefficient();
     }
-    return getCoefficient(level, rad, parameter);
+    return getCoefficient(level, rad, id);
 }
 
 Coefficient VortexData::getCoefficient(const float& height, const float& rad,
-                                       const QString& parameter) const
+                                       const Coefficient::Id& id) const
 {
     int level = getHeightIndex(height);
     if (level < 0) return Coefficient();
-    float minRad = getCoefficient(level, 0, parameter).getRadius();
+    float minRad = getCoefficient(level, 0, id).getRadius();
     if(minRad == -999)
         minRad = 0;
     int radIndex = int(rad - minRad);
@@ -183,13 +178,35 @@ Coefficient VortexData::getCoefficient(const float& height, const float& rad,
         //Message::toScreen("VortexData: GetCoefficient(4): Can't Get Needed Indices: Level = "+QString().setNum(level)+" radIndex = "+QString().setNum(radIndex));
         return Coefficient();
     }
-    return getCoefficient(level, radIndex, parameter);
+    return getCoefficient(level, radIndex, id);
+}
+
+Coefficient VortexData::getCoefficient(const int& lev, const int& rad,
+                                       const QString& parameter) const
+{
+    return getCoefficient(lev, rad, Coefficient::parameterId(parameter));
+}
+
+Coefficient VortexData::getCoefficient(const float& height, const int& rad,
+                                       const QString& parameter) const
+{
+    return getCoefficient(height, rad, Coefficient::parameterId(parameter));
+}
+
+Coefficient VortexData::getCoefficient(const float& height, const float& rad,
+                                       const QString& parameter) const
+{
+    return getCoefficient(height, rad, Coefficient::parameterId(parameter));
 }
 
 void VortexData::setCoefficient(const int& lev, const int& rad, 
-                                const int& coeffNum, const Coefficient &coefficient)
+                                const Coefficient &coefficient)
 {
-    coefficients[lev][rad][coeffNum] = coefficient;
+    // Each coefficient has its own slot
+    Coefficient::Id id = coefficient.getId();
+    if((id < 0) || (id >= MAXCOEFFS))
+        return;
+    coefficients[lev][rad][id] = coefficient;
 }
 
 bool VortexData::operator ==(const VortexData &other)
@@ -223,8 +240,8 @@ void VortexData::saveCoefficients(QString &fname)
 
     for(int lev = 0; lev < _numLevels; lev++)
       for(int rad = 0; rad < _numRadii; rad++)
-	for(int wave = 0; wave < _numWaveNum; wave++) {
-	  Coefficient current = getCoefficient(lev, rad, wave);
+	for(int id = 0; id < MAXCOEFFS; id++) {
+	  const Coefficient& current = coefficients[lev][rad][id];
 	  if(current.getValue() <= _fillv)
 	    continue;
 	  outfile  << current.getLevel()
@@ -83,11 +83,15 @@ public:
     inline void  setCenterStdDev(int index,float value) { if(index<_numLevels) _centerSD[index]=value; }
     inline void  setCenterStdDev(float a[],int howMany) { for(int i=0;i<howMany;i++) setCenterStdDev(i,a[i]); }
 
-    Coefficient getCoefficient(const int& lev, const int& rad,const int& waveNum) const;
+    // Coefficients are stored by Coefficient::Id, the QString versions
+    // are for callers that only have a parameter name
+    Coefficient getCoefficient(const int& lev, const int& rad,const Coefficient::Id& id) const;
+    Coefficient getCoefficient(const float& height, const int& rad,const Coefficient::Id& id) const;
+    Coefficient getCoefficient(const float& height, const float& rad,const Coefficient::Id& id) const;
     Coefficient getCoefficient(const int& lev, const int& rad,const QString& parameter) const;
     Coefficient getCoefficient(const float& height, const int& rad,const QString& parameter) const;
     Coefficient getCoefficient(const float& height, const float& rad,const QString& parameter) const;
-    void	setCoefficient(const int& lev, const int& rad,const int& coeffNum, const Coefficient &coefficient);
+    void	setCoefficient(const int& lev, const int& rad, const Coefficient &coefficient);
     void	saveCoefficients(QString &fname);
 
     // void operator = (const VortexData &other);
@@ -128,7 +132,8 @@ private:
     float _RMW[MAXLEVELS];
     float _RMWUncertainty[MAXLEVELS];
     float _centerSD[MAXLEVELS];
-    Coefficient coefficients[MAXLEVELS][MAXRADII][MAXWAVENUM*2+3];
+    static const int MAXCOEFFS  = MAXWAVENUM*2+3;
+    Coefficient coefficients[MAXLEVELS][MAXRADII][MAXCOEFFS];
 
     QDateTime _time;
     float _maxValidRadius;
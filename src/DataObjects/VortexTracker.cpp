@@ -0,0 +1,178 @@
+/*
+ *  VortexTracker.cpp
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+#include "VortexTracker.h"
+#include "DataObjects/GriddedData.h"
+#include <QMap>
+#include <math.h>
+
+VortexTracker::VortexTracker()
+{
+    _fixError = 2.0;
+    _motionNoise = 5.0;
+    _initialU = 0;
+    _initialV = 0;
+    _refLat = _refLon = 0;
+    _numFixes = 0;
+    for (int i = 0; i < 4; i++) {
+        _state[i] = 0;
+        for (int j = 0; j < 4; j++)
+            _cov[i][j] = 0;
+    }
+}
+
+VortexTracker::~VortexTracker()
+{
+}
+
+void VortexTracker::setNoise(float fixError, float motionNoise)
+{
+    _fixError = fixError;
+    _motionNoise = motionNoise;
+}
+
+void VortexTracker::setInitialMotion(float speed, float direction)
+{
+    // Same convention as workThread::_latlonFirstGuess
+    float angle = 450.0f - direction;
+    if (angle > 360.0f)
+        angle -= 360.0f;
+    angle *= acos(-1.0f) / 180.f;
+    _initialU = speed * 3.6 * cos(angle);
+    _initialV = speed * 3.6 * sin(angle);
+}
+
+void VortexTracker::update(const VortexList& vortexList)
+{
+    _numFixes = 0;
+
+    QMap<QDateTime, int> byTime;
+    for (int i = 0; i < vortexList.count(); i++)
+        byTime.insert(vortexList.at(i).getTime(), i);
+
+    QMap<QDateTime, int>::const_iterator it;
+    for (it = byTime.constBegin(); it != byTime.constEnd(); ++it) {
+        const VortexData& vortex = vortexList.at(it.value());
+        int level = vortex.getBestLevel();
+        if (level < 0)
+            level = 0;
+        float lat = vortex.getLat(level);
+        float lon = vortex.getLon(level);
+        if ((lat == VortexData::_fillv) || (lon == VortexData::_fillv))
+            continue;
+
+        if (_numFixes == 0) {
+            // Start at the first center, the motion is only a rough guess
+            _refLat = lat;
+            _refLon = lon;
+            _time = it.key();
+            for (int i = 0; i < 4; i++)
+                for (int j = 0; j < 4; j++)
+                    _cov[i][j] = 0;
+            _state[0] = _state[1] = 0;
+            _state[2] = _initialU;
+            _state[3] = _initialV;
+            _cov[0][0] = _cov[1][1] = _fixError * _fixError;
+            _cov[2][2] = _cov[3][3] = 20.0 * 20.0;
+            _numFixes = 1;
+            continue;
+        }
+
+        CartesianPoint fix = GriddedData::getCartesianPoint(&_refLat, &_refLon, &lat, &lon);
+        advance(_time.secsTo(it.key()) / 3600.0, _state, _cov);
+        correct(fix.x, fix.y);
+        _time = it.key();
+        _numFixes++;
+    }
+}
+
+bool VortexTracker::predict(const QDateTime& time, float& lat, float& lon, float& uncertainty) const
+{
+    if (_numFixes == 0)
+        return false;
+
+    double state[4];
+    double cov[4][4];
+    for (int i = 0; i < 4; i++) {
+        state[i] = _state[i];
+        for (int j = 0; j < 4; j++)
+            cov[i][j] = _cov[i][j];
+    }
+    advance(_time.secsTo(time) / 3600.0, state, cov);
+
+    LatLon center = GriddedData::getAdjustedLatLon(_refLat, _refLon, state[0], state[1]);
+    lat = center.lat;
+    lon = center.lon;
+    uncertainty = sqrt(0.5 * (cov[0][0] + cov[1][1]));
+    return true;
+}
+
+void VortexTracker::advance(double hours, double state[4], double cov[4][4]) const
+{
+    // x += u dt, y += v dt
+    state[0] += state[2] * hours;
+    state[1] += state[3] * hours;
+
+    // P = F P F' + Q, with F the constant motion step above
+    for (int j = 0; j < 4; j++) {
+        cov[0][j] += hours * cov[2][j];
+        cov[1][j] += hours * cov[3][j];
+    }
+    for (int i = 0; i < 4; i++) {
+        cov[i][0] += hours * cov[i][2];
+        cov[i][1] += hours * cov[i][3];
+    }
+
+    // Random acceleration over the step
+    double q = _motionNoise * _motionNoise;
+    double hours2 = hours * hours;
+    for (int axis = 0; axis < 2; axis++) {
+        cov[axis][axis] += q * hours2 * hours / 3.0;
+        cov[axis][axis + 2] += q * hours2 / 2.0;
+        cov[axis + 2][axis] += q * hours2 / 2.0;
+        cov[axis + 2][axis + 2] += q * hours;
+    }
+}
+
+void VortexTracker::correct(double x, double y)
+{
+    // Only the position is observed
+    double r = _fixError * _fixError;
+    double s00 = _cov[0][0] + r;
+    double s01 = _cov[0][1];
+    double s11 = _cov[1][1] + r;
+    double det = s00 * s11 - s01 * s01;
+    if (det <= 0)
+        return;
+    double inv00 = s11 / det;
+    double inv01 = -s01 / det;
+    double inv11 = s00 / det;
+
+    // K = P H' S^-1
+    double gain[4][2];
+    for (int i = 0; i < 4; i++) {
+        gain[i][0] = _cov[i][0] * inv00 + _cov[i][1] * inv01;
+        gain[i][1] = _cov[i][0] * inv01 + _cov[i][1] * inv11;
+    }
+
+    double dx = x - _state[0];
+    double dy = y - _state[1];
+    for (int i = 0; i < 4; i++)
+        _state[i] += gain[i][0] * dx + gain[i][1] * dy;
+
+    // P = P - K H P
+    double top[2][4];
+    for (int j = 0; j < 4; j++) {
+        top[0][j] = _cov[0][j];
+        top[1][j] = _cov[1][j];
+    }
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            _cov[i][j] -= gain[i][0] * top[0][j] + gain[i][1] * top[1][j];
+}
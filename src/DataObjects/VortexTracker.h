@@ -0,0 +1,63 @@
+/*
+ *  VortexTracker.h
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+#ifndef VORTEXTRACKER_H
+#define VORTEXTRACKER_H
+
+#include <QDateTime>
+#include "DataObjects/VortexList.h"
+
+// A Kalman filter on the centers of a VortexList. The state is the
+// position (km east and north of the first center) and the motion (km/h)
+// of the storm, which is assumed to move at a constant speed apart from
+// random accelerations. predict() gives the center expected at a later
+// time together with its uncertainty, so the simplex can search a box
+// sized by how well the storm is being tracked.
+
+class VortexTracker
+{
+public:
+    VortexTracker();
+    ~VortexTracker();
+
+    // 1 sigma error of a center (km) and of the storm's acceleration
+    // (km/h per hour)
+    void setNoise(float fixError, float motionNoise);
+    // Motion assumed before the centers tell otherwise, as in <vortex>:
+    // speed in m/s and the direction the storm is heading in degrees
+    void setInitialMotion(float speed, float direction);
+
+    // Runs the filter over all the centers of the list in time order
+    void update(const VortexList& vortexList);
+
+    // Center expected at time, and its 1 sigma uncertainty in km. False
+    // if there has been no center to track yet.
+    bool predict(const QDateTime& time, float& lat, float& lon, float& uncertainty) const;
+
+    int getNumFixes() const { return _numFixes; }
+
+private:
+    float _fixError;
+    float _motionNoise;
+    float _initialU;
+    float _initialV;
+
+    float _refLat;
+    float _refLon;
+    QDateTime _time;
+    int _numFixes;
+
+    double _state[4];
+    double _cov[4][4];
+
+    void advance(double hours, double state[4], double cov[4][4]) const;
+    void correct(double x, double y);
+};
+
+#endif
@@ -163,18 +163,15 @@ void CappiDisplay::mousePressEvent(QMouseEvent *event)
 	// int y = currentCappi.getCartesianPointFromIndexJ(currentCappi.getJdim() - lastPoint.y());
 	int y = currentCappi.getCartesianPointFromIndexJ(click_y);
 
-	float *coords = currentCappi.getAdjustedLatLon(currentCappi.getOriginLat(),
+	LatLon coords = currentCappi.getAdjustedLatLon(currentCappi.getOriginLat(),
 						       currentCappi.getOriginLon(),
 						       x, y);
-	// coords[0] -> Lon
-	// coords[1] -> Lat
 	
 	std::cout << "Left press at " << "(" << lastPoint.x() << ", " << lastPoint.y()
 		  << ") -> scaled -> (" << click_x << ", " << click_y << "), "
 	  		  << "Cartesian -> (" << x << ", " << y << ")"
-		  << " coordinates -> (" << coords[0] << ", " << coords[1] << ")"
+		  << " coordinates -> (" << coords.lat << ", " << coords.lon << ")"
 		  << std::endl;
-	delete[] coords;
     }
 }
 
@@ -194,13 +191,12 @@ void CappiDisplay::mouseMoveEvent(QMouseEvent *event)
   int x = currentCappi.getCartesianPointFromIndexI(click_x);
   int y = currentCappi.getCartesianPointFromIndexJ(click_y);
   
-  float *coords = currentCappi.getAdjustedLatLon(currentCappi.getOriginLat(),
+  LatLon coords = currentCappi.getAdjustedLatLon(currentCappi.getOriginLat(),
 						 currentCappi.getOriginLon(),
 						 x, y);
 
   QToolTip::showText(event->globalPos(),
-		     QString("(") + QString::number(coords[0]) + ", " + QString::number(coords[1]) + ")" );
-  delete[] coords;
+		     QString("(") + QString::number(coords.lat) + ", " + QString::number(coords.lon) + ")" );
 }
 
 void CappiDisplay::paintEvent(QPaintEvent * /* event */)
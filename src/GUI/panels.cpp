@@ -11,7 +11,6 @@
 
 #include "panels.h"
 #include "IO/Message.h"
-#include "DataObjects/SimplexData.h"
 #include "DataObjects/VortexData.h"
 #include "DataObjects/GriddedData.h"
 #include <math.h>
@@ -1283,7 +1282,7 @@ CenterPanel::CenterPanel()
 
     QLabel *numPoints = new QLabel(tr("Number of Center Points"));
     numPointsBox = new QSpinBox;
-    numPointsBox->setRange(1,25);
+    numPointsBox->setRange(1,100);
     numPointsBox->setValue(16);
 
     QGridLayout *master = new QGridLayout;
@@ -1683,34 +1682,6 @@ bool CenterPanel::checkValues()
         return false;
     }
 
-    // We have set minimums in the SimplexData containers that will
-    // cause problems if we do not limit the number of levels, radii, and
-    // centers used
-
-    // Last I checked
-    // SimplexData::maxLevels = 15
-    // SimplexData::maxRadii = 30
-    // SimplexData::maxCenters = 25
-    // We get this directly now
-
-    if((int)floor(tLBox->value()-bLBox->value()+1.5)>SimplexData::getMaxLevels()) {
-        emit log(Message(QString(tr("Number of search levels in simplex exceeds the maximum of ")+QString().setNum(SimplexData::getMaxLevels())+tr(", Please decrease the number of levels")),0, this->objectName(), Red,
-                         QString(tr("Too many simplex levels"))));
-        return false;
-    }
-
-    if((int)floor(oRBox->value()-iRBox->value()+1.5)>SimplexData::getMaxRadii()) {
-        emit log(Message(QString(tr("Number of search radii in simplex exceeds the maximum of ")+QString().setNum(SimplexData::getMaxRadii())+tr(", Please decrease the difference between inner and outer radii")),0, this->objectName(), Red,
-                         QString(tr("Simplex outer-inner too large"))));
-        return false;
-    }
-
-    if(numPointsBox->value()>SimplexData::getMaxCenters()) {
-        emit log(Message(QString(),0, this->objectName(), Red,
-                         QString(tr("Number initial centers in simplex exceeds the maximum of ")+QString().setNum(SimplexData::getMaxCenters())+tr(", Please decrease the number of initial centers"))));
-        return false;
-    }
-    
     emit log(Message(QString(), 0, this->objectName(), Green));
     return true;
 }
@@ -0,0 +1,110 @@
+/*
+ *  Cholesky.cpp
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+#include "Cholesky.h"
+#include "Matrix.h"
+
+bool Cholesky::solve(const int& n, const double* normal, const double* rhs,
+		     double* coeff, double* inverseDiag)
+{
+  switch (n) {
+  case 1:  return solve<1>(normal, rhs, coeff, inverseDiag);
+  case 2:  return solve<2>(normal, rhs, coeff, inverseDiag);
+  case 3:  return solve<3>(normal, rhs, coeff, inverseDiag);
+  case 4:  return solve<4>(normal, rhs, coeff, inverseDiag);
+  case 5:  return solve<5>(normal, rhs, coeff, inverseDiag);
+  case 6:  return solve<6>(normal, rhs, coeff, inverseDiag);
+  case 7:  return solve<7>(normal, rhs, coeff, inverseDiag);
+  case 8:  return solve<8>(normal, rhs, coeff, inverseDiag);
+  case 9:  return solve<9>(normal, rhs, coeff, inverseDiag);
+  case 10: return solve<10>(normal, rhs, coeff, inverseDiag);
+  case 11: return solve<11>(normal, rhs, coeff, inverseDiag);
+  case 12: return solve<12>(normal, rhs, coeff, inverseDiag);
+  case 13: return solve<13>(normal, rhs, coeff, inverseDiag);
+  case 14: return solve<14>(normal, rhs, coeff, inverseDiag);
+  case 15: return solve<15>(normal, rhs, coeff, inverseDiag);
+  case 16: return solve<16>(normal, rhs, coeff, inverseDiag);
+  case 17: return solve<17>(normal, rhs, coeff, inverseDiag);
+  default: return false;
+  }
+}
+
+bool Cholesky::lls(const int& numCoeff, const int& numData, float** x,
+		   const float* y, float* coeff, float* stDeviation,
+		   float* stError)
+{
+  if (numData < numCoeff)
+    return false;
+
+  if (numCoeff > maxFixedSize) {
+    // Too big for the stack, use the general routine
+    float* yCopy = const_cast<float*>(y);
+    float stDev;
+    float* errors = new float[numCoeff];
+    bool success = Matrix::lls(numCoeff, numData, x, yCopy, stDev, coeff, errors);
+    if (success && stDeviation)
+      *stDeviation = stDev;
+    if (success && stError)
+      for (int i = 0; i < numCoeff; i++)
+	stError[i] = errors[i];
+    delete[] errors;
+    return success;
+  }
+
+  // Accumulate the normal equations, upper half only
+  int n = numCoeff;
+  double normal[maxFixedSize * maxFixedSize];
+  double rhs[maxFixedSize];
+  for (int row = 0; row < n; row++) {
+    for (int col = row; col < n; col++) {
+      double sum = 0.;
+      for (int i = 0; i < numData; i++)
+	sum += double(x[row][i]) * x[col][i];
+      normal[row * n + col] = sum;
+    }
+    double sum = 0.;
+    for (int i = 0; i < numData; i++)
+      sum += double(x[row][i]) * y[i];
+    rhs[row] = sum;
+  }
+  for (int row = 1; row < n; row++)
+    for (int col = 0; col < row; col++)
+      normal[row * n + col] = normal[col * n + row];
+
+  double solution[maxFixedSize];
+  double inverseDiag[maxFixedSize];
+  if (!solve(n, normal, rhs, solution, stError ? inverseDiag : 0))
+    return false;
+
+  for (int i = 0; i < n; i++)
+    coeff[i] = float(solution[i]);
+
+  if (stDeviation || stError) {
+    // Same definitions as Matrix::lls
+    double sum = 0.;
+    for (int i = 0; i < numData; i++) {
+      double regValue = 0.;
+      for (int j = 0; j < n; j++)
+	regValue += solution[j] * x[j][i];
+      sum += (y[i] - regValue) * (y[i] - regValue);
+    }
+    float stDev;
+    if (numData != numCoeff)
+      stDev = sqrt(sum / double(numData - numCoeff));
+    else
+      stDev = sqrt(sum);
+    if (stDeviation)
+      *stDeviation = stDev;
+    if (stError)
+      for (int i = 0; i < n; i++)
+	stError[i] = stDev * sqrt(fabs(inverseDiag[i]));
+  }
+
+  return true;
+}
@@ -0,0 +1,112 @@
+/*
+ *  Cholesky.h
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+#ifndef CHOLESKY_H
+#define CHOLESKY_H
+
+#include <math.h>
+
+// Least squares for the small, symmetric positive definite normal
+// equations used by the VTD, track and HVVP fits. The systems have
+// at most a couple dozen unknowns, so everything lives on the stack
+// and the loops are specialised on the system size.
+
+class Cholesky
+{
+
+public:
+
+  // Largest system solved on the stack, bigger ones fall back to Matrix::lls
+  static const int maxFixedSize = 17;
+
+  template<int N>
+  static bool solve(const double* normal, const double* rhs, double* coeff,
+		    double* inverseDiag = 0);
+  // Solves normal * coeff = rhs, where normal is a row major N x N
+  // symmetric positive definite matrix. If inverseDiag is given the
+  // diagonal of the inverse of normal is returned in it, which is
+  // what the coefficient error estimates need. Returns false if the
+  // matrix is not positive definite.
+
+  static bool solve(const int& n, const double* normal, const double* rhs,
+		    double* coeff, double* inverseDiag = 0);
+  // Runtime dispatch to the fixed size solvers
+
+  static bool lls(const int& numCoeff, const int& numData, float** x,
+		  const float* y, float* coeff, float* stDeviation = 0,
+		  float* stError = 0);
+  // Drop-in for Matrix::lls: x has numCoeff rows of numData columns.
+  // The standard deviation and coefficient errors are only computed
+  // when asked for.
+
+};
+
+template<int N>
+bool Cholesky::solve(const double* normal, const double* rhs, double* coeff,
+		     double* inverseDiag)
+{
+  // Factor normal = L L'
+  double L[N][N];
+  for (int j = 0; j < N; j++) {
+    double d = normal[j * N + j];
+    for (int k = 0; k < j; k++)
+      d -= L[j][k] * L[j][k];
+    if (!(d > 0.))
+      return false;
+    d = sqrt(d);
+    L[j][j] = d;
+    double dInv = 1. / d;
+    for (int i = j + 1; i < N; i++) {
+      double s = normal[i * N + j];
+      for (int k = 0; k < j; k++)
+	s -= L[i][k] * L[j][k];
+      L[i][j] = s * dInv;
+    }
+  }
+
+  // Forward substitution L z = rhs, then back substitution L' coeff = z
+  double z[N];
+  for (int i = 0; i < N; i++) {
+    double s = rhs[i];
+    for (int k = 0; k < i; k++)
+      s -= L[i][k] * z[k];
+    z[i] = s / L[i][i];
+  }
+  for (int i = N - 1; i >= 0; i--) {
+    double s = z[i];
+    for (int k = i + 1; k < N; k++)
+      s -= L[k][i] * coeff[k];
+    coeff[i] = s / L[i][i];
+  }
+
+  if (inverseDiag) {
+    // inverse(normal) = M' M with M = inverse(L), so the diagonal
+    // is the column sums of M squared
+    double M[N][N];
+    for (int j = 0; j < N; j++) {
+      M[j][j] = 1. / L[j][j];
+      for (int i = j + 1; i < N; i++) {
+	double s = 0.;
+	for (int k = j; k < i; k++)
+	  s -= L[i][k] * M[k][j];
+	M[i][j] = s / L[i][i];
+      }
+    }
+    for (int j = 0; j < N; j++) {
+      double s = 0.;
+      for (int i = j; i < N; i++)
+	s += M[i][j] * M[i][j];
+      inverseDiag[j] = s;
+    }
+  }
+
+  return true;
+}
+
+#endif
@@ -15,6 +15,81 @@
 #include <QFile>
 #include <QTextStream>
 
+#ifdef VORTRAC_ARMADILLO_MATRIX
+#include <armadillo>
+
+// Armadillo versions of lls and gaussJordan, chosen at build time with
+// VORTRAC_ARMADILLO_MATRIX. They fill the same outputs as the hand written
+// routines but work in double precision through BLAS/LAPACK.
+
+bool Matrix::armaLls(const int &numCoeff, const int &numData, float** x, const float* y,
+                     float &stDeviation, float* coeff, float* stError, float** AA)
+{
+    // x holds one row per coefficient, Armadillo wants one column
+    arma::mat X(numData, numCoeff);
+    arma::vec Y(numData);
+    for(int col = 0; col < numCoeff; col++) {
+        for(int i = 0; i < numData; i++) {
+            X(i, col) = x[col][i];
+        }
+    }
+    for(int i = 0; i < numData; i++) {
+        Y(i) = y[i];
+    }
+
+    arma::mat normal = X.t() * X;
+    arma::mat inverse;
+    if(!arma::inv_sympd(inverse, normal) && !arma::inv(inverse, normal))
+        return false;
+    arma::vec solution = inverse * (X.t() * Y);
+    arma::vec residual = Y - X * solution;
+    double sum = arma::dot(residual, residual);
+
+    if(numData!=numCoeff)
+        stDeviation = sqrt(sum/double(numData-numCoeff));
+    else
+        stDeviation = sqrt(sum);
+
+    for(int row = 0; row < numCoeff; row++) {
+        coeff[row] = solution(row);
+        stError[row] = stDeviation*sqrt(fabs(inverse(row, row)));
+        for(int col = 0; col < numCoeff; col++) {
+            AA[row][col] = inverse(row, col);
+        }
+    }
+    return true;
+}
+
+bool Matrix::armaGaussJordan(float **a, float **b, int n, int m)
+{
+    arma::mat A(n, n);
+    arma::mat B(n, m);
+    for(int row = 0; row < n; row++) {
+        for(int col = 0; col < n; col++) {
+            A(row, col) = a[row][col];
+        }
+        for(int col = 0; col < m; col++) {
+            B(row, col) = b[row][col];
+        }
+    }
+
+    arma::mat inverse;
+    if(!arma::inv(inverse, A))
+        return false;
+    arma::mat solution = inverse * B;
+
+    for(int row = 0; row < n; row++) {
+        for(int col = 0; col < n; col++) {
+            a[row][col] = inverse(row, col);
+        }
+        for(int col = 0; col < m; col++) {
+            b[row][col] = solution(row, col);
+        }
+    }
+    return true;
+}
+#endif
+
 Matrix::Matrix() 
 {
 
@@ -26,6 +101,34 @@ Matrix::~Matrix()
 }
 
 bool Matrix::lls(const int &numCoeff,const int &numData,float** &x, float* &y, float &stDeviation, float* &coeff, float* &stError)
+{
+    if(numData < numCoeff) {
+        //emit log(Message("Least Squares: Not Enough Data"));
+        return false;
+    }
+
+    float** AA = new float*[numCoeff];
+    float** BB = new float*[numCoeff];
+    for(int row = 0; row < numCoeff; row++) {
+        AA[row] = new float[numCoeff];
+        BB[row] = new float[1];
+    }
+
+    bool success = lls(numCoeff, numData, x, y, stDeviation, coeff, stError, AA, BB);
+
+    // Clean up
+    for(int row = 0; row < numCoeff; row++) {
+        delete[] AA[row];
+        delete[] BB[row];
+    }
+    delete[] AA;
+    delete[] BB;
+
+    return success;
+}
+
+bool Matrix::lls(const int &numCoeff,const int &numData,float** &x, float* &y, float &stDeviation, float* &coeff, float* &stError,
+                 float** AA, float** BB)
 {
     /*
    * this function solve a problem xa=y
@@ -34,6 +137,8 @@ bool Matrix::lls(const int &numCoeff,const int &numData,float** &x, float* &y, f
    * coeff is the product containing the coefficient values (numCoeff rows)
    * stError is a product containing the estimated error for each coefficent in coeff, (numCoeff rows)
    * stDeviation is the estimated standard deviation of the regression
+   * AA (numCoeff x numCoeff) and BB (numCoeff x 1) are scratch space,
+   * on return AA holds the inverse of the normal matrix
    *
    */
 
@@ -44,20 +149,28 @@ bool Matrix::lls(const int &numCoeff,const int &numData,float** &x, float* &y, f
     // We need at least one more data point than coefficient in order to
     // estimate the standard deviation of the fit.
 
-    float** A = new float*[numCoeff];
-    float** AA = new float*[numCoeff];
-    float* B = new float[numCoeff];
-    float** BB = new float*[numCoeff];
+#ifdef VORTRAC_ARMADILLO_MATRIX
+    return armaLls(numCoeff, numData, x, y, stDeviation, coeff, stError, AA);
+#else
+    return handLls(numCoeff, numData, x, y, stDeviation, coeff, stError, AA, BB);
+#endif
+}
+
+bool Matrix::handLls(const int &numCoeff, const int &numData, float** x, const float* y,
+                     float &stDeviation, float* coeff, float* stError,
+                     float** AA, float** BB)
+{
+    // The hand written lls, solving the normal equations in single
+    // precision with handGaussJordan
+
+    if(numData < numCoeff)
+        return false;
+
     for(int row = 0; row < numCoeff; row++) {
-        A[row] = new float[numCoeff];
-        AA[row] = new float[numCoeff];
-        BB[row] = new float[1];
         for(int col = 0; col < numCoeff; col++) {
-            A[row][col] = 0;
             AA[row][col] = 0;
-            BB[row][0] = 0;
         }
-        B[row] = 0;
+        BB[row][0] = 0;
         coeff[row] = 0;
     }
 
@@ -67,65 +180,19 @@ bool Matrix::lls(const int &numCoeff,const int &numData,float** &x, float* &y, f
     for(long i = 0; i < numData; i++) {
         for(int row = 0; row < numCoeff; row++) {
             for(int col = 0; col < numCoeff; col++) {
-                A[row][col] +=(x[row][i]*x[col][i]);
                 AA[row][col]+=(x[row][i]*x[col][i]);
             }
-            B[row]     +=(x[row][i]*y[i]);
             BB[row][0] +=(x[row][i]*y[i]);
         }
     }
 
-
-    float** Ainv = new float*[numCoeff];
-    for(int p = 0; p < numCoeff; p++)
-        Ainv[p] = new float[numCoeff];
-
-    //The C++ Recipes Code Works so All this can be done away with
-
-    /*
-  // find the inverse of A
-  if(!matrixInverse(A, numCoeff, numCoeff, Ainv)) {
-    Message::toScreen("lls: matrix inverse failed");
-    return false;
-  }
-  
-  // use the inverse of A to find coeff
-  if(!matrixMultiply(Ainv, numCoeff, numCoeff, B, numCoeff, coeff, numCoeff)) {
-    Message::toScreen("lls: Matrix Multiply Failed");
-    return false;
-  }
-  */
-
-
-    //Message::toScreen("Printing AA");
-    //printMatrix(AA, numCoeff, numCoeff);
-
-    //Message::toScreen("Printing BB");
-    //printMatrix(BB, numCoeff, 1);
-
-
-    if(!gaussJordan(AA,BB, numCoeff, 1)) {
+    if(!handGaussJordan(AA,BB, numCoeff, 1)) {
         // emit log(Message("Least Squares Fit Failed"));
         return false;
     }
 
-
-    //printMatrix(BB, numCoeff, 1);
-
-    /*
-  Message::toScreen("CHECK: coeff[0] = "+QString().setNum(coeff[0])+" coeff[1] = "
-   +QString().setNum(coeff[1])+" coeff[2] = "
-   +QString().setNum(coeff[2]));
-  Message::toScreen("     : BB[0][0] = "+QString().setNum(BB[0][0])+" BB[1][0] = "
-   +QString().setNum(BB[1][0])+" BB[2][0] = "
-   +QString().setNum(BB[2][0]));
-  */
-
     for(int i = 0; i < numCoeff; i++) {
         coeff[i] = BB[i][0];
-        for(int j = 0; j < numCoeff; j++) {
-            Ainv[i][j] = AA[i][j];
-        }
     }
 
     // calculate the stDeviation and stError
@@ -150,23 +217,8 @@ bool Matrix::lls(const int &numCoeff,const int &numData,float** &x, float* &y, f
     // calculate the standard error for the coefficients
 
     for(int i = 0; i < numCoeff; i++) {
-        stError[i] = stDeviation*sqrt(fabs(Ainv[i][i]));
-    }
-
-    // Clean up
-    for(int row = 0; row < numCoeff; row++) {
-        delete[] A[row];
-        delete[] AA[row];
-        delete[] BB[row];
+        stError[i] = stDeviation*sqrt(fabs(AA[i][i]));
     }
-    delete[] A;
-    delete[] AA;
-    delete[] B;
-    delete[] BB;
-
-    for(int p = 0; p < numCoeff; p++)
-        delete[] Ainv[p];
-    delete[] Ainv;
 
     return true;
 } 
@@ -579,6 +631,15 @@ bool Matrix::gaussJordan(float **a, float **b, int n, int m)
     // a = nxn coefficient matrix
     // b = nxm matrix
 
+#ifdef VORTRAC_ARMADILLO_MATRIX
+    return armaGaussJordan(a, b, n, m);
+#else
+    return handGaussJordan(a, b, n, m);
+#endif
+}
+
+bool Matrix::handGaussJordan(float **a, float **b, int n, int m)
+{
     int i, icol, irow, j, k, l, ll;
     float big, temp, pivinv;
 
@@ -11,6 +11,8 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include <QString>
+
 class Matrix
 {
 
@@ -24,6 +26,13 @@ public:
   // Preforms a least squares regression on the velocity values
   // on the selected VAD ring to deduce the environmental wind
 
+  static bool lls(const int &numCoeff, const int &numData,float** &x, float* &y,
+		  float &stDeviation, float* &coeff, float* &stError,
+		  float** normal, float** rhs);
+  // Same as above, but works in caller supplied scratch space instead of
+  // allocating: normal must be at least numCoeff x numCoeff and rhs
+  // numCoeff x 1. Used on hot paths that solve many small systems.
+
   static bool oldlls(const int &numCoeff, const long &numData, 
 		  float** &x, float* &y, 
 		  float &stDeviation, float* &coeff, float* &stError, 
@@ -38,6 +47,20 @@ public:
   // Cambridge University Press: 2002,
   // Chapter 2.1 Gauss-Jordan Elimination
 
+  // The solver back ends. lls and gaussJordan use the Armadillo ones when
+  // built with VORTRAC_ARMADILLO_MATRIX and the hand written ones
+  // otherwise, both stay callable so they can be checked against each
+  // other. Arguments as for lls (AA/BB being normal/rhs) and gaussJordan.
+  static bool handLls(const int &numCoeff, const int &numData, float** x, const float* y,
+                      float &stDeviation, float* coeff, float* stError,
+                      float** AA, float** BB);
+  static bool handGaussJordan(float **a, float **b, int n, int m);
+#ifdef VORTRAC_ARMADILLO_MATRIX
+  static bool armaLls(const int &numCoeff, const int &numData, float** x, const float* y,
+                      float &stDeviation, float* coeff, float* stError, float** AA);
+  static bool armaGaussJordan(float **a, float **b, int n, int m);
+#endif
+
   static void printMatrix(float **A, int M, int N);
   static void printMatrix(float *A, int M);
 
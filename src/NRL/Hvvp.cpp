@@ -13,6 +13,7 @@
 #include "Radar/Sweep.h"
 #include <math.h>
 #include "Math/Matrix.h"
+#include "Math/Cholesky.h"
 #include <QFile>
 #include <QDir>
 #include <QTextStream>
@@ -398,7 +399,7 @@ bool Hvvp::findHVVPWinds(bool both)
 			outputFile->close();
 			*/ // comments end here
       
-			flag = Matrix::lls(xlsDimension, count, xls, yls, sse, cc, stand_err);
+			flag = Cholesky::lls(xlsDimension, count, xls, yls, cc, &sse, stand_err);
 
 			//Message::toScreen("SSE = "+QString().setNum(sse));
 
@@ -454,7 +455,7 @@ bool Hvvp::findHVVPWinds(bool both)
 							}
 						}
 						// Message::toScreen("qc_count = "+QString().setNum(qc_count));
-						flag=Matrix::lls(xlsDimension,qc_count,qcxls,qcyls,sse,cc,stand_err);
+						flag=Cholesky::lls(xlsDimension,qc_count,qcxls,qcyls,cc,&sse,stand_err);
 						for(int ii = 0; ii < xlsDimension; ii++) {
 							delete [] qcxls[ii];
 						}
@@ -782,11 +783,10 @@ bool Hvvp::computeCrossBeamWind(float height, float& cc0, float& cc6, float& sse
 
 	if(count >= 6500) {
 
-		float *stand_err = new float[xlsDimension];
 		float *cc = new float[xlsDimension];
 		bool flag, outlier;
 
-		flag = Matrix::lls(xlsDimension, count, xls, yls, sse, cc, stand_err);
+		flag = Cholesky::lls(xlsDimension, count, xls, yls, cc, &sse);
 
 		if(flag) {
 			outlier = false;
@@ -829,7 +829,7 @@ bool Hvvp::computeCrossBeamWind(float height, float& cc0, float& cc6, float& sse
 						}
 					}
 					// Message::toScreen("qc_count = "+QString().setNum(qc_count));
-					flag=Matrix::lls(xlsDimension,qc_count,qcxls,qcyls,sse,cc,stand_err);
+					flag=Cholesky::lls(xlsDimension,qc_count,qcxls,qcyls,cc,&sse);
 					for(int ii = 0; ii < xlsDimension; ii++) {
 						delete [] qcxls[ii];
 					}
@@ -841,12 +841,10 @@ bool Hvvp::computeCrossBeamWind(float height, float& cc0, float& cc6, float& sse
 			// Across-beam component of the environmental wind
 			cc0 = cc[0];
 			cc6 = cc[6];
-			delete[] stand_err;
 			delete[] cc;
 			return true;
 		} 
 		else{
-			delete[] stand_err;
 			delete[] cc;
 		}
 	}
@@ -125,167 +125,59 @@ Ray* AnalyticRadar::addRay()
   newRay->setElevation( elevAngle );
   newRay->setNyquist_vel( nyqVel );
 
-  int numPoints = data->getSphericalRangeLength(azimAngle, elevAngle);
-  /*
-  if((numPoints==0)||(numRays%45==0)) {
-    Message::toScreen("ray = "+QString().setNum(numRays)+" = "+QString().setNum(numPoints));
-    int testNumPoints = data->getSphericalRangeLengthTest(azimAngle,elevAngle);
-    Message::toScreen("Regular "+QString().setNum(numPoints)+" Test "+QString().setNum(testNumPoints));
-  }
-  */
-  float *raw_ref_data;
-  float *raw_ref_positions;
+  // Walk the beam through the analytic grid one cell at a time and
+  // average the cells it crosses into gates of the requested spacing
 
-  QString dataType("DZ");
-  raw_ref_data = data->getSphericalRangeData(dataType,azimAngle, 
-					     elevAngle, numPoints);
-  raw_ref_positions = data->getSphericalRangePosition(azimAngle, elevAngle, 
-						      numPoints);
-
-  // Selects all points from data that are in the theoretical radar beam
-  
-  float furthestPosition = 0.0;
-  for(int z = 0; z < numPoints; z++) {
-    if(raw_ref_positions[z] > furthestPosition)
-      furthestPosition = raw_ref_positions[z];
-  }
-  // determines the distance from the radar where there is sufficient data
-  // for readings
   newRay->allocateRefData( numRefGates );
   float *ref_data = newRay->getRefData();
-  float gateBoundary = 0;
-  
-  // This loop checks the positions of all the points in the ray
-  // for those within a certain gate and sums them together to get an average
-  // reflectivity reading
-  for(int gateNum = 0; gateNum < numRefGates; gateNum++ ) {
-    if(gateBoundary < furthestPosition) {
-      float refSum = 0;
-      int count = 0;
-      for(int p = 0; p < numPoints; p++) {
-	if((raw_ref_positions[p] > gateBoundary) 
-	   && (raw_ref_positions[p] <= (gateBoundary+refGateSp))) {
-	  refSum+= raw_ref_data[p];
-	  count++;
-	}
-      }
-      if(count!=0){
-	ref_data[gateNum] = refSum/(float)count;
-	//if((gateNum%10==0)&&(numRays%45==0))
-	//  Message::toScreen("gate "+QString().setNum(gateNum)+" ref "+QString().setNum(refSum/(float)count));
-      }
-      else
-	ref_data[gateNum] = velNull;
-    }
-    else {
-      ref_data[gateNum] = velNull;
-    }
-    gateBoundary+=refGateSp;
-  }
-
+  data->getSphericalRangeGates(data->getFieldIndex(QString("DZ")), azimAngle,
+			       elevAngle, refGateSp, numRefGates, ref_data);
 
-  delete[] raw_ref_data;
-  delete[] raw_ref_positions;
-  
-  // Selects all points in the theoretical radar beam that may contain valid 
-  // velocity data
-  
-  float *raw_vel_data;
-  float *raw_vel_positions;
-  dataType = QString("VE");
-  raw_vel_data = data->getSphericalRangeData(dataType,azimAngle, 
-					     elevAngle, numPoints);
-  raw_vel_positions = data->getSphericalRangePosition(azimAngle, elevAngle, 
-						      numPoints);
   newRay->allocateVelData( numVelGates );
   newRay->allocateSwData( numVelGates );
-							  
+
   float *vel_data = newRay->getVelData();
-  float *sw_data = newRay->getVelData();
-  gateBoundary = 0;
-  
-  // This loop checks the positions of all the points in the ray
-  // for those within a certain gate and sums them together to get an average
-  // velocity reading with a measure of spectral width
-  // here noise and aliasing are added if requested
+  float *sw_data = newRay->getSwData();
+
+  // The spread of the velocities along the beam within each gate
+  // stands in for the spectral width
+  data->getSphericalRangeGates(data->getFieldIndex(QString("VE")), azimAngle,
+			       elevAngle, velGateSp, numVelGates, vel_data, sw_data);
+
+  // Here noise and aliasing are added if requested
 
   for(int gateNum = 0; gateNum < numVelGates; gateNum++ ) {
-    if(gateBoundary < furthestPosition) {
-      float velSum = 0;
-      int count = 0;
-      for(int p = 0; p < numPoints; p++) {
-	if ((raw_vel_positions[p] > gateBoundary) 
-	    && (raw_vel_positions[p] <= (gateBoundary+velGateSp))) {
-	  velSum += raw_vel_data[p];
-	  count++;
-	}
-      }
-      if(count == 0) {
-	vel_data[gateNum] = velNull;
-	sw_data[gateNum] = velNull;
-      }
-      else {
-	// Good velocity data in this gate
-	vel_data[gateNum] = velSum*cos(elevAngle*deg2rad)/(float)count;
-	//if((gateNum%10==0)&&(numRays%45==0))
-	//  Message::toScreen("gate "+QString().setNum(gateNum)+" vel "+QString().setNum(vel_data[gateNum]));
-	
-	// Add in noise factor, method borrowed from analyticTC
-	// the variable noiseScale changes the relative magnetude of the noise
-	// while the variable noisyGates holds the relative percentage of
-	// gates that noise is applied to.
+    if(vel_data[gateNum] == velNull) {
+      sw_data[gateNum] = velNull;
+      continue;
+    }
+    // Good velocity data in this gate
+    vel_data[gateNum] = vel_data[gateNum]*cos(elevAngle*deg2rad);
 	
-	//srand(time(NULL));  // initializes random number generator
-	int percentOfGates = int(float(rand())/(RAND_MAX*.01));
-	//Message::toScreen("Random gate = "+QString().setNum(percentOfGates));
-	if(percentOfGates < noisyGates) {
-	  //Message::toScreen("Got Noise");
-	  srand(time(NULL));  // reinitializes random number generator
-	  float noise = rand()%1000/1000.0 -.5;
-	  vel_data[gateNum]+= noiseScale*noise;
-	}
-
-	// collect all the point's velocities for spectral width calculations
-	// spectral width is the standard deviation of the velocity readings
-
-	float *sw_points = new float[count];
-	int countAgain = 0;
-	for(int p = 0; p < numPoints; p++) {
-	  if ((raw_vel_positions[p] > gateBoundary) 
-	      && (raw_vel_positions[p] < gateBoundary+velGateSp)) {
-	    sw_points[countAgain] = raw_vel_data[p];
-	    countAgain++;
-	  }
-	}
-	float swSum = 0;
-	for(int q = 0; q < count; q++) {
-      
-	  swSum = (sw_points[q]-vel_data[gateNum])*(sw_points[q]-vel_data[gateNum]);
-	}
-	sw_data[gateNum] = sqrt(swSum/(float)count);
+    // Add in noise factor, method borrowed from analyticTC
+    // the variable noiseScale changes the relative magnetude of the noise
+    // while the variable noisyGates holds the relative percentage of
+    // gates that noise is applied to.
 	
-	// Velocity aliasing when applicable
+    int percentOfGates = int(float(rand())/(RAND_MAX*.01));
+    if(percentOfGates < noisyGates) {
+      srand(time(NULL));  // reinitializes random number generator
+      float noise = rand()%1000/1000.0 -.5;
+      vel_data[gateNum]+= noiseScale*noise;
+    }
+
+    // Velocity aliasing when applicable
 	
-       	while(fabs(vel_data[gateNum]) > nyqVel) {
-	  if(vel_data[gateNum] > 0) {
-	    vel_data[gateNum]-=2*nyqVel;
-	  }
-	  else {
-	    vel_data[gateNum]+=2*nyqVel;
-	  }
-       	}
+    while(fabs(vel_data[gateNum]) > nyqVel) {
+      if(vel_data[gateNum] > 0) {
+	vel_data[gateNum]-=2*nyqVel;
+      }
+      else {
+	vel_data[gateNum]+=2*nyqVel;
       }
     }
-    else {
-      vel_data[gateNum] = velNull;
-      sw_data[gateNum] = velNull;
-    } 
-    gateBoundary+=velGateSp;
   }
 
-  delete[] raw_vel_data;
-  delete[] raw_vel_positions;
-    
   newRay->setRef_numgates( numRefGates );
   newRay->setVel_numgates( numVelGates ); 
   newRay->setRef_gatesp( 1000*refGateSp );
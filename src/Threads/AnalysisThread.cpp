@@ -205,7 +205,7 @@ void AnalysisThread::run()
                 float changeInY = distanceMoved*sin(stormDirection);
                 QString message("changeInX = "+QString().setNum(changeInX)+" changeInY = "+QString().setNum(changeInY));
                 //emit(log(Message(message,0,this->objectName())));
-                float *newLatLon = GriddedData::getAdjustedLatLon(vortexLat,vortexLon, changeInX, changeInY);
+                LatLon newLatLon = GriddedData::getAdjustedLatLon(vortexLat,vortexLon, changeInX, changeInY);
 
                 // Get initial lat and lon
                 float initLat = configData->getParam(vortex,"lat").toFloat();
@@ -229,26 +229,24 @@ void AnalysisThread::run()
                 distanceMoved = elapsedSeconds*stormSpeed/1000.0;
                 changeInX = distanceMoved*cos(stormDirection);
                 changeInY = distanceMoved*sin(stormDirection);
-                float *extrapLatLon = GriddedData::getAdjustedLatLon(initLat,initLon, changeInX, changeInY);
-                float relDist = GriddedData::getCartesianDistance(extrapLatLon[0],extrapLatLon[1],newLatLon[0],newLatLon[1]);
+                LatLon extrapLatLon = GriddedData::getAdjustedLatLon(initLat,initLon, changeInX, changeInY);
+                float relDist = GriddedData::getCartesianDistance(extrapLatLon.lat,extrapLatLon.lon,newLatLon.lat,newLatLon.lon);
 
                 if (relDist > 10) {
                     QString distString;
                     QString M1 = "Previous Simplex center "+distString.setNum((int)relDist)+" (>10 km) from User estimated center, may be lost or need to update estimate";
                     QString M2 = "Last Simplex & Estimate "+distString.setNum((int)relDist)+" km apart";
                     emit log(Message(M1,0,this->objectName(),Yellow, M2));
-                    vortexLat = extrapLatLon[0];
-                    vortexLon = extrapLatLon[1];
+                    vortexLat = extrapLatLon.lat;
+                    vortexLon = extrapLatLon.lon;
                 } else {
                     // Message::toScreen("Old vortexLat = "+QString().setNum(vortexLat)+" Old vortexLon = "+QString().setNum(vortexLon));
-                    // Message::toScreen("New vortexLat = "+QString().setNum(newLatLon[0])+" New vortexLon = "+QString().setNum(newLatLon[1]));
-                    vortexLat = newLatLon[0];
-                    vortexLon = newLatLon[1];
+                    // Message::toScreen("New vortexLat = "+QString().setNum(newLatLon.lat)+" New vortexLon = "+QString().setNum(newLatLon.lon));
+                    vortexLat = newLatLon.lat;
+                    vortexLon = newLatLon.lon;
                     QString currentCenter("Using ("+QString().setNum(vortexLat)+", "+QString().setNum(vortexLon)+") from previous simplex");
                     emit log(Message(currentCenter,1,this->objectName())); // 5 %
                 }
-                delete [] newLatLon;
-                delete [] extrapLatLon;
             }
         }
         else {
@@ -357,11 +355,10 @@ void AnalysisThread::run()
                 float distanceMoved = elapsedSeconds*stormSpeed/1000.0;
                 float changeInX = distanceMoved*cos(stormDirection);
                 float changeInY = distanceMoved*sin(stormDirection);
-                float *newLatLon = GriddedData::getAdjustedLatLon(vortexLat,vortexLon, changeInX, changeInY);
+                LatLon newLatLon = GriddedData::getAdjustedLatLon(vortexLat,vortexLon, changeInX, changeInY);
 
-                vortexLat = newLatLon[0];
-                vortexLon = newLatLon[1];
-                delete [] newLatLon;
+                vortexLat = newLatLon.lat;
+                vortexLon = newLatLon.lon;
                 QString currentCenter("Using ("+QString().setNum(vortexLat)+", "+QString().setNum(vortexLon)+") from user input");
                 emit log(Message(currentCenter,1,this->objectName())); // 5 %
             }
@@ -533,15 +530,14 @@ void AnalysisThread::run()
         QDomElement simplex = configData->getConfig("center");
         float radarLat = configData->getParam(radar,"lat").toFloat();
         float radarLon = configData->getParam(radar,"lon").toFloat();
-        float* xyValues = _gridData->getCartesianPoint(&radarLat, &radarLon, &levelLat, &levelLon);
-        float xPercent = float(_gridData->getIndexFromCartesianPointI(xyValues[0])+1)/_gridData->getIdim();
-        float yPercent = float(_gridData->getIndexFromCartesianPointJ(xyValues[1])+1)/_gridData->getJdim();
+        CartesianPoint xyValues = _gridData->getCartesianPoint(&radarLat, &radarLon, &levelLat, &levelLon);
+        float xPercent = float(_gridData->getIndexFromCartesianPointI(xyValues.x)+1)/_gridData->getIdim();
+        float yPercent = float(_gridData->getIndexFromCartesianPointJ(xyValues.y)+1)/_gridData->getJdim();
         float rmwEstimate = vortexData->getRMW(vortexIndex)/(_gridData->getIGridsp()*_gridData->getIdim());
         float sMin = configData->getParam(simplex, "innerradius").toFloat()/(_gridData->getIGridsp()*_gridData->getIdim());
         float sMax = configData->getParam(simplex, "outerradius").toFloat()/(_gridData->getIGridsp()*_gridData->getIdim());
         float vMax = configData->getParam(vtd, "outerradius").toFloat()/(_gridData->getIGridsp()*_gridData->getIdim());
         emit newCappiInfo(xPercent, yPercent, rmwEstimate, sMin, sMax, vMax, vortexLat, vortexLon, levelLat, levelLon);
-        delete [] xyValues;
 
 
         if(!hasConvergingCenters)
@@ -0,0 +1,110 @@
+/*
+ *  ParallelFor.h
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <vector>
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+// Spreads the items 0..count-1 of a loop over the global thread pool.
+// task(worker, item) is called once per item; workers take the next item
+// from a shared counter, so uneven items balance themselves. A worker
+// number stays with one thread for the whole run, so tasks keep their
+// scratch space (a VTD, ring buffers) in a per-worker slot. The calling
+// thread is always worker 0 and does its share, which also makes nested
+// runs safe: helpers that never got a pool thread are taken back.
+
+class ParallelFor
+{
+
+ public:
+
+  // Number of workers run() will use. numThreads <= 0 means one per core.
+  static int workers(const int& count, int numThreads)
+  {
+    if (numThreads <= 0)
+      numThreads = QThread::idealThreadCount();
+    if (numThreads > count)
+      numThreads = count;
+    return (numThreads < 1) ? 1 : numThreads;
+  }
+
+  template<class Task>
+  static void run(const int& count, const int& numThreads, Task& task)
+  {
+    int numWorkers = workers(count, numThreads);
+    if (numWorkers == 1) {
+      for (int i = 0; i < count; i++)
+        task(0, i);
+      return;
+    }
+
+    QAtomicInt next(0);
+    QSemaphore finished;
+    QThreadPool* pool = QThreadPool::globalInstance();
+    std::vector< Helper<Task>* > helpers(numWorkers - 1);
+    for (int w = 1; w < numWorkers; w++) {
+      helpers[w - 1] = new Helper<Task>(task, w, count, next, finished);
+      pool->start(helpers[w - 1]);
+    }
+
+    work(task, 0, count, next);
+
+    // Anything still queued has nothing left to do
+    for (int w = 1; w < numWorkers; w++) {
+      if (pool->tryTake(helpers[w - 1]))
+        finished.release();
+    }
+    finished.acquire(numWorkers - 1);
+    for (int w = 1; w < numWorkers; w++)
+      delete helpers[w - 1];
+  }
+
+ private:
+
+  template<class Task>
+  static void work(Task& task, const int& worker, const int& count, QAtomicInt& next)
+  {
+    for (int i = next.fetchAndAddRelaxed(1); i < count; i = next.fetchAndAddRelaxed(1))
+      task(worker, i);
+  }
+
+  template<class Task>
+  class Helper : public QRunnable
+  {
+   public:
+    Helper(Task& task, int worker, int count, QAtomicInt& next, QSemaphore& finished)
+      : _task(task), _worker(worker), _count(count), _next(next), _finished(finished)
+    {
+      // ParallelFor::run owns them, the pool must not delete them
+      setAutoDelete(false);
+    }
+
+    void run()
+    {
+      work(_task, _worker, _count, _next);
+      _finished.release();
+    }
+
+   private:
+    Task& _task;
+    int _worker;
+    int _count;
+    QAtomicInt& _next;
+    QSemaphore& _finished;
+  };
+
+};
+
+#endif
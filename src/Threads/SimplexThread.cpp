@@ -10,7 +10,10 @@
 
 #include <QtGui>
 #include <math.h>
+#include <vector>
+#include <algorithm>
 #include "SimplexThread.h"
+#include "Threads/ParallelFor.h"
 #include "DataObjects/Coefficient.h"
 #include "DataObjects/Center.h"
 #include "VTD/VTDFactory.h"
@@ -28,7 +31,16 @@ SimplexThread::SimplexThread(QObject* parent):QObject(parent)
     configData = NULL;
 
     _dataGaps = NULL;
+    _simplexVTD = NULL;
     _vtdCoeffs = NULL;
+    _azimuthSamples = 0;
+    _ringCacheSize = 4096;
+    _numThreads = 0;
+    _guessUncertainty = -1;
+
+    endX = endY = VTind = NULL;
+    Xconv = Yconv = VTconv = NULL;
+    startX = startY = NULL;
 }
 
 SimplexThread::~SimplexThread()
@@ -52,6 +64,351 @@ void SimplexThread::initParam(Configuration *wholeConfig,GriddedData *dataPtr,fl
     configData = wholeConfig;
 }
 
+void SimplexThread::setGuessUncertainty(float uncertainty)
+{
+    _guessUncertainty = uncertainty;
+}
+
+// Runs a ParallelFor task over a list of its items only
+template<class Task>
+class SubsetTask
+{
+public:
+    SubsetTask(Task& task, const std::vector<int>& items) : _task(task), _items(items) {}
+
+    void operator()(int worker, int i)
+    {
+        _task(worker, _items[i]);
+    }
+
+private:
+    Task& _task;
+    const std::vector<int>& _items;
+};
+
+bool SimplexThread::WindMemo::find(float x, float y, float radius, float height, float& VT)
+{
+    if (!_enabled)
+        return false;
+    for (int n = 0; n < _size; n++) {
+        if ((_x[n] == x) && (_y[n] == y) && (_radius[n] == radius) && (_height[n] == height)) {
+            VT = _VT[n];
+            _hits++;
+            return true;
+        }
+    }
+    _misses++;
+    return false;
+}
+
+void SimplexThread::WindMemo::insert(float x, float y, float radius, float height, float VT)
+{
+    if (!_enabled)
+        return;
+    _x[_next] = x;
+    _y[_next] = y;
+    _radius[_next] = radius;
+    _height[_next] = height;
+    _VT[_next] = VT;
+    _next = (_next + 1) % MAXENTRIES;
+    if (_size < MAXENTRIES)
+        _size++;
+}
+
+float SimplexThread::StartBox::influence(const RingJob& job) const
+{
+    return job.warm ? warmRadiusOfInfluence : radiusOfInfluence;
+}
+
+void SimplexThread::StartBox::start(const RingJob& job, int point, float& RefI, float& RefJ) const
+{
+    // A warm job gets a smaller box centered on its seed
+    float cornerI = job.cornerI;
+    float cornerJ = job.cornerJ;
+    float incr = boxIncr;
+    if (job.warm) {
+        incr = warmBoxIncr;
+        cornerI = job.seedX - 0.5 * incr * float(int(boxRowLength) - 1);
+        cornerJ = job.seedY - 0.5 * incr * float(int(boxRowLength) - 1);
+    }
+
+    if (point < boxRowLength)
+        RefI = cornerI + float(point) * incr;
+    else
+        RefI = cornerI + float((point) % int(boxRowLength)) * incr;
+
+    RefJ = cornerJ + float(point / int(boxRowLength)) * incr;
+}
+
+// Lays out the points of one (level, ring) and fits their starting vertices
+class SimplexThread::InitialTask
+{
+public:
+    SimplexThread* simplex;
+    Workspace* workspaces;
+    const RingJob* jobs;
+    StartBox box;
+    QString velField;
+    float* startX;
+    float* startY;
+    float* initialX;
+    float* initialY;
+    float* initialVT;
+
+    void operator()(int worker, int j)
+    {
+        const RingJob& job = jobs[j];
+        if (!job.inside)
+            return;
+        workspaces[worker].windMemo.clear();
+
+        float influence = box.influence(job);
+        for (int point = 0; point < box.numPoints; point++) {
+            float RefI, RefJ;
+            box.start(job, point, RefI, RefJ);
+
+            int item = job.firstPoint + point;
+            startX[item] = RefI;
+            startY[item] = RefJ;
+
+            // Initialize vertices
+            float sqr32 = 0.866025;
+            float* x = initialX + 3 * item;
+            float* y = initialY + 3 * item;
+            x[0] = RefI;
+            y[0] = RefJ + influence;
+            x[1] = RefI + sqr32 * influence;
+            y[1] = RefJ - 0.5 * influence;
+            x[2] = RefI - sqr32 * influence;
+            y[2] = RefJ - 0.5 * influence;
+        }
+
+        //Calculate mean wind at each vertex
+        int first = 3 * job.firstPoint;
+        simplex->_getSymWinds(workspaces[worker], 3 * (int)box.numPoints, initialX + first, initialY + first,
+                              job.radius, job.height, velField, initialVT + first);
+    }
+};
+
+// Runs the simplex search of one point
+class SimplexThread::SearchTask
+{
+public:
+    SimplexThread* simplex;
+    Workspace* workspaces;
+    const RingJob* jobs;
+    const int* itemJob;
+    float maxIterations;
+    float warmIterations;
+    float convergeCriterion;
+    float flatTolerance;
+    int flatIterations;
+    qint64 timeBudget;   // ns from the start of findCenter, 0 for none
+    int numWorkers;
+    int numSearches;
+    QAtomicInt* finished;
+    QString velField;
+    const float* initialX;
+    const float* initialY;
+    const float* initialVT;
+    float* endX;
+    float* endY;
+    float* VT;
+    bool* converged;
+    bool* budgetHit;
+
+    void operator()(int worker, int item)
+    {
+        const RingJob& job = jobs[itemJob[item]];
+
+        // The time left in the volume is shared evenly between the searches
+        // still to run, as many of them run at once as there are workers
+        qint64 deadline = -1;
+        if (timeBudget > 0) {
+            qint64 now = simplex->_volumeTimer.nsecsElapsed();
+            qint64 left = std::max(timeBudget - now, (qint64)0);
+            int searchesLeft = std::max(numSearches - finished->loadAcquire(), 1);
+            deadline = std::min(now + left * numWorkers / searchesLeft, timeBudget);
+        }
+
+        workspaces[worker].windMemo.clear();
+        float vertexRows[3][2];
+        float* vertexPtr[3] = { vertexRows[0], vertexRows[1], vertexRows[2] };
+        float** vertex = vertexPtr;
+        float vertexVT[3];
+        float vertexSum[2];
+        for (int v = 0; v <= 2; v++) {
+            vertex[v][0] = initialX[3 * item + v];
+            vertex[v][1] = initialY[3 * item + v];
+            vertexVT[v] = initialVT[3 * item + v];
+            workspaces[worker].windMemo.insert(vertex[v][0], vertex[v][1], job.radius, job.height, vertexVT[v]);
+        }
+        vertexSum[0] = 0;
+        vertexSum[1] = 0;
+
+        // Run the simplex search loop
+        float VTsolution = .0, Xsolution = 0. , Ysolution=0.;
+        simplex->_getVertexSum(vertex, vertexSum);
+        SearchEnd end = simplex->_centerIterate(workspaces[worker], vertex, vertexSum, vertexVT,
+                                                job.warm ? warmIterations : maxIterations,
+                                                convergeCriterion, flatTolerance, flatIterations, deadline,
+                                                job.radius, job.height,
+                                                velField, VTsolution, Xsolution, Ysolution);
+        converged[item] = (end != IterationsExceeded);
+        budgetHit[item] = (end == BudgetExceeded);
+        finished->fetchAndAddOrdered(1);
+
+        // Done with simplex loop, should have values for the current point
+        if ((VTsolution < 100.) and (VTsolution > 0.)) {
+            endX[item] = Xsolution;
+            endY[item] = Ysolution;
+            VT[item]   = VTsolution;
+        } else {
+            endX[item] = Center::_fillv;
+            endY[item] = Center::_fillv;
+            VT[item]   = Center::_fillv;
+        }
+    }
+};
+
+// Finds the centers of one (level, ring) on a grid of candidates instead
+// of with the simplex. The wind is evaluated on a coarse grid over the
+// area the simplex searches could reach, each point climbs from its start
+// to a local maximum of that grid, and every maximum is refined on finer
+// and finer 5 by 5 grids about it. The cost is fixed by the spacing and
+// the number of refinements, whatever the wind field looks like.
+class SimplexThread::GridTask
+{
+public:
+    SimplexThread* simplex;
+    Workspace* workspaces;
+    const RingJob* jobs;
+    StartBox box;
+    float coarseSpacing;
+    int refinements;
+    QString velField;
+    float* startX;
+    float* startY;
+    float* endX;
+    float* endY;
+    float* VT;
+    bool* converged;
+
+    void operator()(int worker, int j)
+    {
+        const RingJob& job = jobs[j];
+        if (!job.inside)
+            return;
+        Workspace& ws = workspaces[worker];
+        ws.windMemo.clear();
+
+        // The starts of the points, and the area their searches could cover
+        float influence = box.influence(job);
+        float minI = 0, maxI = 0, minJ = 0, maxJ = 0;
+        for (int point = 0; point < box.numPoints; point++) {
+            int item = job.firstPoint + point;
+            box.start(job, point, startX[item], startY[item]);
+            if ((point == 0) || (startX[item] < minI)) minI = startX[item];
+            if ((point == 0) || (startX[item] > maxI)) maxI = startX[item];
+            if ((point == 0) || (startY[item] < minJ)) minJ = startY[item];
+            if ((point == 0) || (startY[item] > maxJ)) maxJ = startY[item];
+        }
+        minI -= influence;
+        maxI += influence;
+        minJ -= influence;
+        maxJ += influence;
+
+        // Coarse pass, all the candidates fitted together
+        int nI = int(floor((maxI - minI) / coarseSpacing)) + 1;
+        int nJ = int(floor((maxJ - minJ) / coarseSpacing)) + 1;
+        std::vector<float> x(nI * nJ), y(nI * nJ), wind(nI * nJ);
+        for (int jj = 0; jj < nJ; jj++) {
+            for (int ii = 0; ii < nI; ii++) {
+                x[jj * nI + ii] = minI + ii * coarseSpacing;
+                y[jj * nI + ii] = minJ + jj * coarseSpacing;
+            }
+        }
+        simplex->_getSymWinds(ws, nI * nJ, x.data(), y.data(), job.radius, job.height, velField, wind.data());
+
+        std::vector<int> peaks;
+        std::vector<float> peakX, peakY, peakVT;
+        for (int point = 0; point < box.numPoints; point++) {
+            int item = job.firstPoint + point;
+            converged[item] = true;
+
+            // Climb to the best neighbour until there is none better
+            int ii = std::min(std::max(int(floor((startX[item] - minI) / coarseSpacing + .5)), 0), nI - 1);
+            int jj = std::min(std::max(int(floor((startY[item] - minJ) / coarseSpacing + .5)), 0), nJ - 1);
+            for (;;) {
+                int bestI = ii, bestJ = jj;
+                for (int dj = -1; dj <= 1; dj++) {
+                    for (int di = -1; di <= 1; di++) {
+                        int ni = ii + di, nj = jj + dj;
+                        if ((ni < 0) || (ni >= nI) || (nj < 0) || (nj >= nJ))
+                            continue;
+                        if (wind[nj * nI + ni] > wind[bestJ * nI + bestI]) {
+                            bestI = ni;
+                            bestJ = nj;
+                        }
+                    }
+                }
+                if ((bestI == ii) && (bestJ == jj))
+                    break;
+                ii = bestI;
+                jj = bestJ;
+            }
+            int node = jj * nI + ii;
+
+            // Points that reach the same maximum share its refinement
+            int peak = std::find(peaks.begin(), peaks.end(), node) - peaks.begin();
+            if (peak == (int)peaks.size()) {
+                float bestX = x[node], bestY = y[node], bestVT = wind[node];
+                if (bestVT != -999.0f)
+                    refine(ws, job, bestX, bestY, bestVT);
+                peaks.push_back(node);
+                peakX.push_back(bestX);
+                peakY.push_back(bestY);
+                peakVT.push_back(bestVT);
+            }
+
+            if ((peakVT[peak] < 100.) and (peakVT[peak] > 0.)) {
+                endX[item] = peakX[peak];
+                endY[item] = peakY[peak];
+                VT[item]   = peakVT[peak];
+            } else {
+                endX[item] = Center::_fillv;
+                endY[item] = Center::_fillv;
+                VT[item]   = Center::_fillv;
+            }
+        }
+    }
+
+    void refine(Workspace& ws, const RingJob& job, float& bestX, float& bestY, float& bestVT)
+    {
+        float x[25], y[25], wind[25];
+        float spacing = coarseSpacing;
+        for (int pass = 0; pass < refinements; pass++) {
+            spacing *= 0.5;
+            for (int n = 0; n < 25; n++) {
+                x[n] = bestX + (n % 5 - 2) * spacing;
+                y[n] = bestY + (n / 5 - 2) * spacing;
+            }
+            simplex->_getSymWinds(ws, 25, x, y, job.radius, job.height, velField, wind);
+            int best = -1;
+            for (int n = 0; n < 25; n++) {
+                if (wind[n] > bestVT) {
+                    best = n;
+                    bestVT = wind[n];
+                }
+            }
+            if (best >= 0) {
+                bestX = x[best];
+                bestY = y[best];
+            }
+        }
+    }
+};
+
 bool SimplexThread::findCenter(SimplexList* simplexList)
 {
 
@@ -70,12 +427,33 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
     float boxSize = configData->getParam(simplexCfg,QString("boxdiameter")).toFloat();
     float numPoints = configData->getParam(simplexCfg,QString("numpoints")).toFloat();
 
-    if(numPoints >= 25) {
-      std::cerr << "*** Error: <numpoints> is greater than 25 "
-		<< "(the size of the data structures in the simplex thread)" << std::endl;
+    if(numPoints < 1) {
+      std::cerr << "*** Error: <numpoints> must be at least 1" << std::endl;
       return false;
     }
 
+    // A tracked first guess comes with an uncertainty. The box is then
+    // centered on the guess and only made big enough to cover it, with
+    // the points thinned to keep their spacing.
+    bool centerBox = false;
+    if ((_guessUncertainty > 0) && (numPoints > 1)) {
+        centerBox = true;
+        float minBoxSize = 4.0;
+        QString minBox = configData->getParam(simplexCfg,QString("minboxdiameter"));
+        if (minBox != "")
+            minBoxSize = minBox.toFloat();
+        float trackedBoxSize = std::max(4.0f * _guessUncertainty, minBoxSize);
+        if (trackedBoxSize < boxSize) {
+            int rowLength = std::max(2, (int)floor(sqrt(numPoints) * trackedBoxSize / boxSize + 0.5));
+            if (rowLength * rowLength < numPoints)
+                numPoints = rowLength * rowLength;
+            boxSize = trackedBoxSize;
+        }
+        emit log(Message(QString("Tracked first guess within %1 km, searching a %2 km box with %3 points")
+                         .arg(_guessUncertainty, 0, 'f', 1).arg(boxSize, 0, 'f', 1).arg((int)numPoints),
+                         0, this->objectName()));
+    }
+
     float boxRowLength = sqrt(numPoints);
     float boxIncr = boxSize / (sqrt(numPoints) - 1);
 
@@ -85,6 +463,72 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
     float ringWidth = configData->getParam(simplexCfg,QString("ringwidth")).toFloat();
     int   maxWave = configData->getParam(simplexCfg,QString("maxwavenumber")).toInt();
 
+    // Optionally resample each ring to a fixed number of azimuths
+    QString azimuthSamples = configData->getParam(simplexCfg,QString("azimuthsamples"));
+    if (azimuthSamples != "")
+        _azimuthSamples = azimuthSamples.toInt();
+
+    // Rings pulled out of the grid are kept, one cache per worker
+    QString cacheSize = configData->getParam(simplexCfg,QString("ringcachesize"));
+    if (cacheSize != "")
+        _ringCacheSize = cacheSize.toInt();
+
+    // The searches are spread over this many threads, 0 for one per core
+    QString threads = configData->getParam(simplexCfg,QString("threads"));
+    if (threads != "")
+        _numThreads = threads.toInt();
+
+    // The centers are found with the simplex, or with <method>grid</method>
+    // by refining a grid of candidates <gridrefinements> times from
+    // <gridspacing> km
+    bool gridSearch = ("grid" == configData->getParam(simplexCfg,QString("method")));
+    float gridSpacing = 2.0;
+    QString spacing = configData->getParam(simplexCfg,QString("gridspacing"));
+    if (spacing != "")
+        gridSpacing = spacing.toFloat();
+    int gridRefinements = 3;
+    QString refinements = configData->getParam(simplexCfg,QString("gridrefinements"));
+    if (refinements != "")
+        gridRefinements = refinements.toInt();
+    if (gridSearch && ((gridSpacing <= 0) || (gridRefinements < 0))) {
+        emit log(Message(QString("Grid search needs a <gridspacing> above 0 km and <gridrefinements> of 0 or more, searching with the simplex instead"),
+                         0, this->objectName(), Yellow, QString("Bad Grid Search Settings")));
+        gridSearch = false;
+    }
+
+    // A search also stops once its best wind has gained less than
+    // <flattolerance> m/s in <flatiterations> iterations, and all the
+    // searches of the volume are fitted into <timebudget> seconds. Both
+    // are off unless they are set.
+    float flatTolerance = 0;
+    QString flat = configData->getParam(simplexCfg,QString("flattolerance"));
+    if (flat != "")
+        flatTolerance = flat.toFloat();
+    int flatIterations = 10;
+    QString flatCount = configData->getParam(simplexCfg,QString("flatiterations"));
+    if (flatCount != "")
+        flatIterations = flatCount.toInt();
+    qint64 timeBudget = 0;
+    QString budget = configData->getParam(simplexCfg,QString("timebudget"));
+    if (budget != "")
+        timeBudget = (qint64)(budget.toFloat() * 1.0e9);
+    _volumeTimer.start();
+
+    // Optionally start each (level, ring) from the previous volume's
+    // center, with a smaller box and fewer iterations
+    bool warmStart = ("true" == configData->getParam(simplexCfg,QString("warmstart")))
+        && (simplexList->count() > 0);
+    float warmBoxSize = 0.25 * boxSize;
+    QString warmBox = configData->getParam(simplexCfg,QString("warmstartbox"));
+    if (warmBox != "")
+        warmBoxSize = warmBox.toFloat();
+    float warmIterations = floor(maxIterations / 2);
+    QString warmMaxIterations = configData->getParam(simplexCfg,QString("warmstartiterations"));
+    if (warmMaxIterations != "")
+        warmIterations = warmMaxIterations.toFloat();
+    float warmBoxIncr = (boxRowLength > 1) ? warmBoxSize / (int(boxRowLength) - 1) : 0;
+    float warmRadiusOfInfluence = radiusOfInfluence * warmBoxSize / boxSize;
+
     // Define the maximum allowable data gaps
 
     _dataGaps = new float[maxWave+1];
@@ -96,6 +540,7 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
     //SETP 2: initialize a VTD object for whole simplex to use
 
     _simplexVTD = VTDFactory::createVTD(geometry, closure, maxWave, _dataGaps);
+    _simplexVTD->setFixedAzimuths(_azimuthSamples > 0);
     _vtdCoeffs  = new Coefficient[20];
 
     //STEP 3: perform simplex algorithm
@@ -117,171 +562,367 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
     // the ring count should be divided by the ring width
     simplexData->setNumPointsUsed((int)numPoints);
 
-    // Allocate memory for the vertices
-    float** vertex = new float*[3];
-    vertex[0 ]= new float[2];
-    vertex[1] = new float[2];
-    vertex[2] = new float[2];
-    float* VT = new float[3];
-    float* vertexSum = new float[2];
-
-    // Loop through the levels and rings,
+    // Lay out every (level, ring) first. Only this moves the grid's
+    // reference point, the searches give their centers explicitly.
     // TODO Should this have some reference to grid spacing?
     // see GriddedData::setAbsoluteReferencePoint
     // TODO firstLevel is 1. How come not 0.5?
 
+    std::vector<RingJob> jobs;
+    int numItems = 0;
     // for (float height = firstLevel; height <= lastLevel; height++) {
     for (float height = firstLevel; height <= lastLevel; height += gridData->getKGridsp()) {
         for (float radius = firstRing; radius <= lastRing; radius++) {
 
             gridData->setAbsoluteReferencePoint(_latGuess, _lonGuess, height);
+            RingJob job;
+            job.height = height;
+            job.radius = radius;
             // Set the corner of the box
-            float CornerI = gridData->getCartesianRefPointI();
-            float CornerJ = gridData->getCartesianRefPointJ();
+            job.cornerI = gridData->getCartesianRefPointI();
+            job.cornerJ = gridData->getCartesianRefPointJ();
+            if (centerBox) {
+                job.cornerI -= 0.5 * boxSize;
+                job.cornerJ -= 0.5 * boxSize;
+            }
+            job.inside = (gridData->getRefPointI() >= 0) && (gridData->getRefPointJ() >= 0)
+                && (gridData->getRefPointK() >= 0);
+            job.warm = false;
+            job.seedX = job.seedY = 0;
+            if (warmStart && job.inside)
+                job.warm = _previousCenter(simplexList->last(), height, radius, job.seedX, job.seedY);
+            job.firstPoint = numItems;
+            if (job.inside)
+                numItems += (int)numPoints;
+            jobs.push_back(job);
+        }
+    }
+    int numJobs = jobs.size();
+
+    // Where each point starts and ends up
+    float* itemStartX = new float[numItems];
+    float* itemStartY = new float[numItems];
+    float* itemEndX = new float[numItems];
+    float* itemEndY = new float[numItems];
+    float* itemVT = new float[numItems];
+    bool* itemConverged = new bool[numItems];
+    bool* itemBudgetHit = new bool[numItems];
+    for (int item = 0; item < numItems; item++)
+        itemBudgetHit[item] = false;
+    int* itemJob = new int[numItems];
+    for (int j = 0; j < numJobs; j++) {
+        if (jobs[j].inside) {
+            for (int point = 0; point < (int)numPoints; point++)
+                itemJob[jobs[j].firstPoint + point] = j;
+        }
+    }
 
-            // std::cout << "** ring: "<< radius <<" RefI: " << CornerI << " RefJ: "<< CornerJ << std::endl;
+    // Starting vertices of every point, so the rings of a (level, ring)
+    // can be pulled out and fitted together
+    float* initialX = new float[3 * numItems];
+    float* initialY = new float[3 * numItems];
+    float* initialVT = new float[3 * numItems];
+
+    // Every worker gets its own VTD, coefficients and ring cache
+    int numWorkers = ParallelFor::workers(std::max(numJobs, numItems), _numThreads);
+    Workspace* workspaces = new Workspace[numWorkers];
+    for (int w = 0; w < numWorkers; w++) {
+        workspaces[w].vtd = (w == 0) ? _simplexVTD : _simplexVTD->clone();
+        workspaces[w].coeffs = (w == 0) ? _vtdCoeffs : new Coefficient[20];
+        workspaces[w].ringCache.setMaxEntries(_ringCacheSize);
+        workspaces[w].windMemo.setEnabled(gridSearch);
+    }
 
-            float RefK = gridData->getCartesianRefPointK();
-            float RefI = CornerI;
-            float RefJ = CornerJ;
+    StartBox startBox;
+    startBox.numPoints = numPoints;
+    startBox.boxRowLength = boxRowLength;
+    startBox.boxIncr = boxIncr;
+    startBox.radiusOfInfluence = radiusOfInfluence;
+    startBox.warmBoxIncr = warmBoxIncr;
+    startBox.warmRadiusOfInfluence = warmRadiusOfInfluence;
+
+    InitialTask initialTask;
+    initialTask.simplex = this;
+    initialTask.workspaces = workspaces;
+    initialTask.jobs = jobs.data();
+    initialTask.box = startBox;
+    initialTask.velField = velField;
+    initialTask.startX = itemStartX;
+    initialTask.startY = itemStartY;
+    initialTask.initialX = initialX;
+    initialTask.initialY = initialY;
+    initialTask.initialVT = initialVT;
+
+    SearchTask searchTask;
+    searchTask.simplex = this;
+    searchTask.workspaces = workspaces;
+    searchTask.jobs = jobs.data();
+    searchTask.itemJob = itemJob;
+    searchTask.maxIterations = maxIterations;
+    searchTask.warmIterations = warmIterations;
+    searchTask.convergeCriterion = convergeCriterion;
+    searchTask.velField = velField;
+    searchTask.initialX = initialX;
+    searchTask.initialY = initialY;
+    searchTask.initialVT = initialVT;
+    searchTask.endX = itemEndX;
+    searchTask.endY = itemEndY;
+    searchTask.VT = itemVT;
+    searchTask.converged = itemConverged;
+    searchTask.budgetHit = itemBudgetHit;
+    searchTask.flatTolerance = flatTolerance;
+    searchTask.flatIterations = flatIterations;
+    searchTask.timeBudget = timeBudget;
+    searchTask.numWorkers = numWorkers;
+    searchTask.numSearches = numItems;
+    QAtomicInt searchesFinished(0);
+    searchTask.finished = &searchesFinished;
+
+    GridTask gridTask;
+    gridTask.simplex = this;
+    gridTask.workspaces = workspaces;
+    gridTask.jobs = jobs.data();
+    gridTask.box = startBox;
+    gridTask.coarseSpacing = gridSpacing;
+    gridTask.refinements = gridRefinements;
+    gridTask.velField = velField;
+    gridTask.startX = itemStartX;
+    gridTask.startY = itemStartY;
+    gridTask.endX = itemEndX;
+    gridTask.endY = itemEndY;
+    gridTask.VT = itemVT;
+    gridTask.converged = itemConverged;
+
+    if (gridSearch) {
+        ParallelFor::run(numJobs, numWorkers, gridTask);
+    } else {
+        ParallelFor::run(numJobs, numWorkers, initialTask);
+        ParallelFor::run(numItems, numWorkers, searchTask);
+    }
 
-            if ((gridData->getRefPointI() < 0) || (gridData->getRefPointJ() < 0) || (gridData->getRefPointK() < 0))  {
-                emit log(Message(QString("Initial simplex guess is outside CAPPI"),0,this->objectName()));
-                archiveNull(simplexData, radius, height, numPoints);
+    if (warmStart) {
+        // Warm rings where most points failed are searched again from the full box
+        std::vector<int> retryJobs;
+        std::vector<int> retryItems;
+        int numWarm = 0;
+        for (int j = 0; j < numJobs; j++) {
+            if (!jobs[j].warm)
                 continue;
+            numWarm++;
+            int good = 0;
+            for (int point = 0; point < (int)numPoints; point++) {
+                int item = jobs[j].firstPoint + point;
+                if (itemConverged[item] && (itemVT[item] != Center::_fillv))
+                    good++;
+            }
+            if (2 * good < (int)numPoints) {
+                jobs[j].warm = false;
+                retryJobs.push_back(j);
+                for (int point = 0; point < (int)numPoints; point++)
+                    retryItems.push_back(jobs[j].firstPoint + point);
             }
+        }
+        if (gridSearch && !retryJobs.empty()) {
+            SubsetTask<GridTask> retryGrid(gridTask, retryJobs);
+            ParallelFor::run(retryJobs.size(), numWorkers, retryGrid);
+        } else if (!retryJobs.empty()) {
+            SubsetTask<InitialTask> retryInitial(initialTask, retryJobs);
+            ParallelFor::run(retryJobs.size(), numWorkers, retryInitial);
+            searchTask.numSearches += retryItems.size();
+            SubsetTask<SearchTask> retrySearch(searchTask, retryItems);
+            ParallelFor::run(retryItems.size(), numWorkers, retrySearch);
+        }
+        emit log(Message(QString("Warm start: %1 of %2 rings seeded from the previous volume, %3 fell back to the full box")
+                         .arg(numWarm).arg(numJobs).arg(retryJobs.size()),
+                         0, this->objectName()));
+    }
 
-            // Initialize mean values
-
-            int meanCount = 0;
-            meanXall = meanYall = meanVTall = 0;
-            meanX = meanY = meanVT = 0;
-            stdDevVertexAll = stdDevVTAll = 0;
-            stdDevVertex = stdDevVT = 0;
-            convergingCenters = 0;
-
-            // Loop through the initial guesses
-	    // std::cout << "** Num of points: " << numPoints << std::endl;
-
-            for (int point = 0; point < numPoints; point++) {
-                if (point < boxRowLength)
-                    RefI = CornerI + float(point) * boxIncr;
-                else
-                    RefI = CornerI + float((point) % int(boxRowLength)) * boxIncr;
-
-                RefJ = CornerJ + float(point / int(boxRowLength)) * boxIncr;
-
-                startX[point] = RefI;
-                startY[point] = RefJ;
-
-                // Initialize vertices
-                float sqr32 = 0.866025;
-                vertex[0][0] = RefI;
-                vertex[0][1] = RefJ + radiusOfInfluence;
-                vertex[1][0] = RefI + sqr32 * radiusOfInfluence;
-                vertex[1][1] = RefJ - 0.5 * radiusOfInfluence;
-                vertex[2][0] = RefI - sqr32 * radiusOfInfluence;
-                vertex[2][1] = RefJ - 0.5 * radiusOfInfluence;
-                vertexSum[0] = 0;
-                vertexSum[1] = 0;
-
-                for (int v = 0; v <= 2; v++) {
-		  //Calculate mean wind at each vertex
-		  VT[v] = _getSymWind(vertex[v][0], vertex[v][1], int(RefK), radius, height, velField);
-                }
+    endX = new float[(int)numPoints];
+    endY = new float[(int)numPoints];
+    VTind = new float[(int)numPoints];
+    Xconv = new float[(int)numPoints];
+    Yconv = new float[(int)numPoints];
+    VTconv = new float[(int)numPoints];
+    startX = new float[(int)numPoints];
+    startY = new float[(int)numPoints];
+
+    // Reduce the rings in the serial order, so the results and the log
+    // don't depend on how the points were shared out
+
+    for (int j = 0; j < numJobs; j++) {
+        float height = jobs[j].height;
+        float radius = jobs[j].radius;
+        ringBudgetExceeded = false;
+
+        if (!jobs[j].inside) {
+            emit log(Message(QString("Initial simplex guess is outside CAPPI"),0,this->objectName()));
+            archiveNull(simplexData, radius, height, numPoints);
+            continue;
+        }
 
-                // Run the simplex search loop
-                float VTsolution = .0, Xsolution = 0. , Ysolution=0.;
-                _getVertexSum(vertex, vertexSum);
-                _centerIterate(vertex, vertexSum, VT, maxIterations, convergeCriterion, RefK, radius,
-			       height, velField, VTsolution, Xsolution, Ysolution);
-
-                // Done with simplex loop, should have values for the current point
-                if ((VTsolution < 100.) and (VTsolution > 0.)) {
-                    // Add to sum
-                    meanXall  += Xsolution;
-                    meanYall  += Ysolution;
-                    meanVTall += VTsolution;
-                    meanCount++;
-                    // Add to array for storage
-                    endX[point]  = Xsolution;
-                    endY[point]  = Ysolution;
-                    VTind[point] = VTsolution;
-                } else {
-                    endX[point]  = Center::_fillv;
-                    endY[point]  = Center::_fillv;
-                    VTind[point] = Center::_fillv;
-                }
-            } //point loop end
+        // Initialize mean values
+
+        int meanCount = 0;
+        meanXall = meanYall = meanVTall = 0;
+        meanX = meanY = meanVT = 0;
+        stdDevVertexAll = stdDevVTAll = 0;
+        stdDevVertex = stdDevVT = 0;
+        convergingCenters = 0;
+
+        for (int point = 0; point < numPoints; point++) {
+            int item = jobs[j].firstPoint + point;
+            if (!itemConverged[item])
+                emit log(Message(QString("Maximum iterations exceeded in Simplex"),0,this->objectName()));
+            if (itemBudgetHit[item])
+                ringBudgetExceeded = true;
+
+            startX[point] = itemStartX[item];
+            startY[point] = itemStartY[item];
+            endX[point]  = itemEndX[item];
+            endY[point]  = itemEndY[item];
+            VTind[point] = itemVT[item];
+            if (VTind[point] != Center::_fillv) {
+                // Add to sum
+                meanXall  += endX[point];
+                meanYall  += endY[point];
+                meanVTall += VTind[point];
+                meanCount++;
+            }
+        }
 
-	    // std::cout << "Mean count before: " << meanCount << std::endl;
+	// std::cout << "Mean count before: " << meanCount << std::endl;
+
+        if (meanCount == 0) {
+            archiveNull(simplexData, radius, height, numPoints);
+        } else {
+            meanXall = meanXall / float(meanCount);
+            meanYall = meanYall / float(meanCount);
+            meanVTall = meanVTall / float(meanCount);
+            for (int i = 0; i < numPoints; i++) {
+                if ((endX[i] != -999.) and (endY[i] != -999.) and (VTind[i] != -999.)) {
+                    stdDevVertexAll += ((endX[i] - meanXall)
+                                        * (endX[i] - meanXall) + (endY[i] - meanYall)
+                                        * (endY[i] - meanYall));
+                    stdDevVTAll += (VTind[i] - meanVTall) * (VTind[i] - meanVTall);
+                }
+            }
+            stdDevVertexAll = sqrt(stdDevVertexAll/float(meanCount - 1));
+            stdDevVTAll = sqrt(stdDevVTAll/float(meanCount - 1));
+
+            // Now remove centers beyond 1 standard deviation. Centers that
+            // all ended up in the same place are all kept.
+            meanCount = 0;
+            for (int i = 0; i < numPoints; i++) {
+                if ((endX[i] != -999.) and (endY[i] != -999.) and (VTind[i] != -999.)) {
+                    float vertexDist = sqrt((endX[i] - meanXall) * (endX[i] - meanXall)
+                                            + (endY[i] - meanYall) * (endY[i] - meanYall));
+                    if (vertexDist <= stdDevVertexAll) {
+                        Xconv[meanCount] = endX[i];
+                        Yconv[meanCount] = endY[i];
+                        VTconv[meanCount] = VTind[i];
+                        meanX += endX[i];
+                        meanY += endY[i];
+                        meanVT+= VTind[i];
+                        meanCount++;
+                    }
+                }
+            }
+	    // std::cout << "Mean count after: " << meanCount << std::endl;
 
             if (meanCount == 0) {
                 archiveNull(simplexData, radius, height, numPoints);
             } else {
-                meanXall = meanXall / float(meanCount);
-                meanYall = meanYall / float(meanCount);
-                meanVTall = meanVTall / float(meanCount);
-                for (int i = 0; i < numPoints; i++) {
-                    if ((endX[i] != -999.) and (endY[i] != -999.) and (VTind[i] != -999.)) {
-                        stdDevVertexAll += ((endX[i] - meanXall)
-					    * (endX[i] - meanXall) + (endY[i] - meanYall)
-					    * (endY[i] - meanYall));
-                        stdDevVTAll += (VTind[i] - meanVTall) * (VTind[i] - meanVTall);
-                    }
-                }
-                stdDevVertexAll = sqrt(stdDevVertexAll/float(meanCount - 1));
-                stdDevVTAll = sqrt(stdDevVTAll/float(meanCount - 1));
-
-                // Now remove centers beyond 1 standard deviation
-                meanCount = 0;
-                for (int i = 0; i < numPoints; i++) {
-                    if ((endX[i] != -999.) and (endY[i] != -999.) and (VTind[i] != -999.)) {
-                        float vertexDist = sqrt((endX[i] - meanXall) * (endX[i] - meanXall)
-						+ (endY[i] - meanYall) * (endY[i] - meanYall));
-                        if (vertexDist < stdDevVertexAll) {
-                            Xconv[meanCount] = endX[i];
-                            Yconv[meanCount] = endY[i];
-                            VTconv[meanCount] = VTind[i];
-                            meanX += endX[i];
-                            meanY += endY[i];
-                            meanVT+= VTind[i];
-                            meanCount++;
-                        }
-                    }
+                meanX = meanX / float(meanCount);
+                meanY = meanY / float(meanCount);
+                meanVT = meanVT / float(meanCount);
+                convergingCenters = meanCount;
+                for (int i = 0; i < convergingCenters - 1; i++) {
+                    stdDevVertex += ((Xconv[i] - meanX) * (Xconv[i] - meanX)+ (Yconv[i] - meanY) * (Yconv[i] - meanY));
+                    stdDevVT += (VTconv[i] - meanVT) * (VTconv[i] - meanVT);
                 }
-		// std::cout << "Mean count after: " << meanCount << std::endl;
-
-                if (meanCount == 0) {
-                    archiveNull(simplexData, radius, height, numPoints);
-                } else {
-                    meanX = meanX / float(meanCount);
-                    meanY = meanY / float(meanCount);
-                    meanVT = meanVT / float(meanCount);
-                    convergingCenters = meanCount;
-                    for (int i = 0; i < convergingCenters - 1; i++) {
-                        stdDevVertex += ((Xconv[i] - meanX) * (Xconv[i] - meanX)+ (Yconv[i] - meanY) * (Yconv[i] - meanY));
-                        stdDevVT += (VTconv[i] - meanVT) * (VTconv[i] - meanVT);
-                    }
-                    stdDevVertex = sqrt(stdDevVertex / float(meanCount - 1));
-                    stdDevVT = sqrt(stdDevVT / float(meanCount - 1));
+                stdDevVertex = sqrt(stdDevVertex / float(meanCount - 1));
+                stdDevVT = sqrt(stdDevVT / float(meanCount - 1));
 
-                    // All done with this radius and height, archive it
-                    archiveCenters(simplexData, radius, height, numPoints);
+                // All done with this radius and height, archive it
+                archiveCenters(simplexData, radius, height, numPoints);
+            }
+        }
+    } //ring loop end
+
+    if (timeBudget > 0) {
+        int ringsStopped = 0;
+        for (int j = 0; j < numJobs; j++) {
+            for (int point = 0; jobs[j].inside && (point < (int)numPoints); point++) {
+                if (itemBudgetHit[jobs[j].firstPoint + point]) {
+                    ringsStopped++;
+                    break;
                 }
             }
-        } //ring loop end
-    } //height loop end
+        }
+        emit log(Message(QString("Time budget: %1 of %2 rings stopped early, %3 s used")
+                         .arg(ringsStopped).arg(numJobs)
+                         .arg(_volumeTimer.elapsed() / 1000.0, 0, 'f', 1),
+                         0, this->objectName()));
+    }
+
+    int cacheHits = 0;
+    int cacheMisses = 0;
+    for (int w = 0; w < numWorkers; w++) {
+        cacheHits += workspaces[w].ringCache.getHits();
+        cacheMisses += workspaces[w].ringCache.getMisses();
+    }
+    int ringLookups = cacheHits + cacheMisses;
+    if (ringLookups > 0) {
+        emit log(Message(QString("Ring cache: %1 hits, %2 misses (%3% hit rate)")
+                         .arg(cacheHits).arg(cacheMisses)
+                         .arg(100.0 * cacheHits / ringLookups, 0, 'f', 1),
+                         0, this->objectName()));
+    }
+
+    int memoHits = 0;
+    int memoMisses = 0;
+    for (int w = 0; w < numWorkers; w++) {
+        memoHits += workspaces[w].windMemo.getHits();
+        memoMisses += workspaces[w].windMemo.getMisses();
+    }
+    int windLookups = memoHits + memoMisses;
+    if (windLookups > 0) {
+        emit log(Message(QString("Vertex memo: %1 hits, %2 misses (%3% hit rate)")
+                         .arg(memoHits).arg(memoMisses)
+                         .arg(100.0 * memoHits / windLookups, 0, 'f', 1),
+                         0, this->objectName()));
+    }
 
     simplexList->append(*simplexData);
     delete simplexData;
-    // Deallocate memory for the vertices
-    delete[] vertex[0];
-    delete[] vertex[1];
-    delete[] vertex[2];
-    delete[] vertex;
-    delete[] VT;
-    delete[] vertexSum;
+
+    for (int w = 1; w < numWorkers; w++) {
+        delete workspaces[w].vtd;
+        delete[] workspaces[w].coeffs;
+    }
+    delete[] workspaces;
+    delete[] itemStartX;
+    delete[] itemStartY;
+    delete[] itemEndX;
+    delete[] itemEndY;
+    delete[] itemVT;
+    delete[] itemConverged;
+    delete[] itemBudgetHit;
+    delete[] itemJob;
+    delete[] initialX;
+    delete[] initialY;
+    delete[] initialVT;
+    delete[] endX;
+    delete[] endY;
+    delete[] VTind;
+    delete[] Xconv;
+    delete[] Yconv;
+    delete[] VTconv;
+    delete[] startX;
+    delete[] startY;
+    endX = endY = VTind = NULL;
+    Xconv = Yconv = VTconv = NULL;
+    startX = startY = NULL;
 
     return true;
 }
@@ -299,6 +940,7 @@ void SimplexThread::archiveCenters(SimplexData* simplexData, float radius, float
     simplexData->setCenterStdDev(level, ring, stdDevVertex);
     simplexData->setVTUncertainty(level, ring, stdDevVT);
     simplexData->setNumConvergingCenters(level, ring, (int)convergingCenters);
+    simplexData->setBudgetExceeded(level, ring, ringBudgetExceeded);
     for (int point = 0; point < (int)numPoints; point++) {
         // We want to use the real radius and height in the center for use
         // later so these should be given in km
@@ -311,6 +953,30 @@ void SimplexThread::archiveCenters(SimplexData* simplexData, float radius, float
     }
 }
 
+bool SimplexThread::_previousCenter(const SimplexData& previous, float height, float radius,
+                                    float& seedX, float& seedY)
+{
+    // Find the converged mean center of the same (level, ring) in the
+    // previous volume, if there is one
+    for (int level = 0; level < previous.getNumLevels(); level++) {
+        if (fabs(previous.getHeight(level) - height) > 0.5 * gridData->getKGridsp())
+            continue;
+        for (int ring = 0; ring < previous.getNumRadii(); ring++) {
+            if (fabs(previous.getRadius(ring) - radius) > 0.5)
+                continue;
+            if ((previous.getNumConvergingCenters(level, ring) <= 0)
+                || (previous.getMeanX(level, ring) == SimplexData::_fillv)
+                || (previous.getMeanY(level, ring) == SimplexData::_fillv))
+                return false;
+            seedX = previous.getMeanX(level, ring);
+            seedY = previous.getMeanY(level, ring);
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
 void SimplexThread::archiveNull(SimplexData* simplexData, float& radius, float& height, float& numPoints)
 {
 
@@ -326,6 +992,7 @@ void SimplexThread::archiveNull(SimplexData* simplexData, float& radius, float&
     simplexData->setCenterStdDev(level, ring, -999);
     simplexData->setVTUncertainty(level, ring, -999);
     simplexData->setNumConvergingCenters(level, ring, (int)0);
+    simplexData->setBudgetExceeded(level, ring, ringBudgetExceeded);
     for (int point = 0; point < (int)numPoints; point++) {
         Center indCenter(Center::_fillv, Center::_fillv, Center::_fillv,Center::_fillv,
                          Center::_fillv, level, ring);
@@ -351,41 +1018,20 @@ inline void SimplexThread::_getVertexSum(float** vertex,float* vertexSum)
     }
 }
 
-float SimplexThread::_simplexTest(float**& vertex,float*& VT,float*& vertexSum,
-                                 float& radius, float& height, float& RefK,
+float SimplexThread::_simplexTest(Workspace& ws, float**& vertex,float*& VT,float*& vertexSum,
+                                 float& radius, float& height,
                                  QString& velField, int& low, double factor)
 {
     // Test a simplex vertex
     float VTtest = -999;
-    float* vertexTest = new float[2];
+    float vertexTest[2];
     float factor1 = (1.0 - factor)/2;
     float factor2 = factor1 - factor;
     for (int i=0; i<=1; i++)
         vertexTest[i] = vertexSum[i]*factor1 - vertex[low][i]*factor2;
 
-    // Get the data
-    gridData->setCartesianReferencePoint(int(vertexTest[0]),int(vertexTest[1]),int(RefK));
-    int numData = gridData->getCylindricalAzimuthLength(radius, height);
-    float* ringData = new float[numData];
-    float* ringAzimuths = new float[numData];
-    gridData->getCylindricalAzimuthData(velField, numData, radius, height, ringData);
-    gridData->getCylindricalAzimuthPosition(numData, radius, height, ringAzimuths);
-
-    // Call vtd
-    if (_simplexVTD->analyzeRing(vertexTest[0], vertexTest[1], radius, height, numData,
-				 ringData,ringAzimuths, _vtdCoeffs, vtdStdDev)) {
-        if (_vtdCoeffs[0].getParameter() == "VTC0") {
-            VTtest = _vtdCoeffs[0].getValue();
-        } else {
-            emit log(Message("Error retrieving VTC0 in simplex!"));
-        }
-    } else {
-        VTtest = -999;
-        // emit log(Message("Not enough data in simplex ring"));
-    }
-
-    delete[] ringData;
-    delete[] ringAzimuths;
+    // Fit the ring about the test vertex
+    VTtest = _getSymWind(ws, vertexTest[0], vertexTest[1], radius, height, velField);
 
     // If its a better point than the worst, replace it
     if (VTtest > VT[low]) {
@@ -395,21 +1041,55 @@ float SimplexThread::_simplexTest(float**& vertex,float*& VT,float*& vertexSum,
             vertex[low][i] = vertexTest[i];
         }
     }
-    delete[] vertexTest;
     return VTtest;
 
 }
 
-float SimplexThread::_getSymWind(float vertex_x,float vertex_y,int RefK,float radius,float height,QString velField)
+int SimplexThread::_getRingData(Workspace& ws, float vertex_x, float vertex_y, float radius,
+                                float height, QString& velField,
+                                float*& ringData, float*& ringAzimuths)
+{
+    // Pull out the ring around the grid point of the vertex, either the
+    // raw cells in the ring or a fixed number of interpolated azimuths.
+    // The arrays belong to the worker's ring cache, so the caller must not
+    // free them. The grid's reference point is left alone.
+
+    int refI = int(vertex_x);
+    int refJ = int(vertex_y);
+    int numData = 0;
+    if (ws.ringCache.find(refI, refJ, radius, height, numData, ringData, ringAzimuths))
+        return numData;
+
+    float refX = refI;
+    float refY = refJ;
+    if (_azimuthSamples > 0) {
+        numData = _azimuthSamples;
+        ringData = new float[numData];
+        ringAzimuths = new float[numData];
+        gridData->getCylindricalAzimuthSamples(velField, refX, refY, numData, radius, height,
+                                               ringData, ringAzimuths);
+    } else {
+        int ringOffset = 0;
+        gridData->getCylindricalRingsLength(1, &refX, &refY, radius, height, &numData);
+        ringData = new float[numData];
+        ringAzimuths = new float[numData];
+        gridData->getCylindricalRingsData(velField, 1, &refX, &refY, radius, height,
+                                          &ringOffset, ringData, ringAzimuths);
+    }
+    ws.ringCache.insert(refI, refJ, radius, height, numData, ringData, ringAzimuths);
+    return numData;
+}
+
+float SimplexThread::_getSymWind(Workspace& ws, float vertex_x,float vertex_y,float radius,float height,QString& velField)
 {
     float VT=-999.0f;
-    gridData->setCartesianReferencePoint(int(vertex_x),int(vertex_y),RefK);
-    int numData = gridData->getCylindricalAzimuthLength(radius, height);    // TODO
-    float* ringData = new float[numData];
-    float* ringAzimuths = new float[numData];
-    gridData->getCylindricalAzimuthData(velField, numData, radius, height, ringData);
+    if (ws.windMemo.find(vertex_x, vertex_y, radius, height, VT))
+        return VT;
+
+    float* ringData;
+    float* ringAzimuths;
     // azimuth data should look like sine wave
-    gridData->getCylindricalAzimuthPosition(numData, radius, height, ringAzimuths);
+    int numData = _getRingData(ws, vertex_x, vertex_y, radius, height, velField, ringData, ringAzimuths);
 #if 0
     // TODO debug
     for(int d = 0; d < numData; d++) {
@@ -417,29 +1097,119 @@ float SimplexThread::_getSymWind(float vertex_x,float vertex_y,int RefK,float ra
 		<< " azimuth: " << ringAzimuths[d] << std::endl;
     }
 #endif
-    Coefficient*  vtdCoeffs=new Coefficient[20];
     float   vtdStdDev;
 
-    // vtCoeff[0..numCoeffs].value will be set by this call
+    // ws.coeffs[0..numCoeffs].value will be set by this call
+
+    if (ws.vtd->analyzeRing(vertex_x, vertex_y, radius, height, numData, ringData, ringAzimuths, ws.coeffs, vtdStdDev)) {
+        if (ws.coeffs[0].getId() == Coefficient::VTC0)
+            VT = ws.coeffs[0].getValue();
+    }
+
+    ws.windMemo.insert(vertex_x, vertex_y, radius, height, VT);
+    return VT;
+}
+
+void SimplexThread::_getSymWinds(Workspace& ws, int numCenters, const float* vertex_x, const float* vertex_y,
+                                 float radius, float height, QString& velField, float* VT)
+{
+    // _getSymWind for many vertices at once. The rings all have the same
+    // shape, so they come out of the grid in one go and are fitted back
+    // to back in the same workspace.
+
+    // Only the centers this search has not fitted yet go to the VTD
+    float* fitX = new float[numCenters];
+    float* fitY = new float[numCenters];
+    int* fitIndex = new int[numCenters];
+    int numFits = 0;
+    for (int n = 0; n < numCenters; n++) {
+        if (!ws.windMemo.find(vertex_x[n], vertex_y[n], radius, height, VT[n])) {
+            fitX[numFits] = vertex_x[n];
+            fitY[numFits] = vertex_y[n];
+            fitIndex[numFits++] = n;
+        }
+    }
+    if (numFits == 0) {
+        delete[] fitX;
+        delete[] fitY;
+        delete[] fitIndex;
+        return;
+    }
 
-    if (_simplexVTD->analyzeRing(vertex_x, vertex_y, radius, height, numData, ringData, ringAzimuths, vtdCoeffs, vtdStdDev)) {
-        if (vtdCoeffs[0].getParameter() == "VTC0")
-            VT = vtdCoeffs[0].getValue();
+    // The rings are pulled out about the same grid points as _getSymWind uses
+    float* refX = new float[numFits];
+    float* refY = new float[numFits];
+    int* ringOffset = new int[numFits];
+    int* ringLength = new int[numFits];
+    for (int n = 0; n < numFits; n++) {
+        refX[n] = int(fitX[n]);
+        refY[n] = int(fitY[n]);
+    }
+    int totalData = 0;
+    if (_azimuthSamples > 0) {
+        totalData = numFits * _azimuthSamples;
+        for (int n = 0; n < numFits; n++)
+            ringLength[n] = _azimuthSamples;
+    } else {
+        totalData = gridData->getCylindricalRingsLength(numFits, refX, refY, radius, height, ringLength);
+    }
+    for (int n = 0, offset = 0; n < numFits; n++) {
+        ringOffset[n] = offset;
+        offset += ringLength[n];
+    }
+    float* ringData = new float[totalData + 1];
+    float* ringAzimuths = new float[totalData + 1];
+    if (_azimuthSamples > 0) {
+        for (int n = 0; n < numFits; n++)
+            gridData->getCylindricalAzimuthSamples(velField, refX[n], refY[n], _azimuthSamples,
+                                                   radius, height, ringData + ringOffset[n],
+                                                   ringAzimuths + ringOffset[n]);
+    } else {
+        gridData->getCylindricalRingsData(velField, numFits, refX, refY, radius, height,
+                                          ringOffset, ringData, ringAzimuths);
     }
 
+    const int coeffStride = 20;
+    Coefficient* coeffs = new Coefficient[numFits * coeffStride];
+    float* stdDev = new float[numFits];
+    bool* valid = new bool[numFits];
+    ws.vtd->analyzeCenters(numFits, fitX, fitY, radius, height, ringOffset, ringLength,
+                           ringData, ringAzimuths, coeffs, coeffStride, stdDev, valid);
+    for (int n = 0; n < numFits; n++) {
+        Coefficient& vtc0 = coeffs[n * coeffStride];
+        float fitVT = (valid[n] && (vtc0.getId() == Coefficient::VTC0)) ? vtc0.getValue() : -999.0f;
+        VT[fitIndex[n]] = fitVT;
+        ws.windMemo.insert(fitX[n], fitY[n], radius, height, fitVT);
+    }
+
+    delete[] fitX;
+    delete[] fitY;
+    delete[] fitIndex;
+    delete[] refX;
+    delete[] refY;
+    delete[] ringOffset;
+    delete[] ringLength;
     delete[] ringData;
     delete[] ringAzimuths;
-    delete[] vtdCoeffs;
-    return VT;
+    delete[] coeffs;
+    delete[] stdDev;
+    delete[] valid;
 }
 
-void SimplexThread::_centerIterate(float** vertex, float* vertexSum, float* VT, int maxIterations, float convergeCriterion,
-                                   float RefK, float radius, float height, QString velField,
-                                   float& VTsolution, float& Xsolution, float& Ysolution)
+SimplexThread::SearchEnd SimplexThread::_centerIterate(Workspace& ws, float** vertex, float* vertexSum, float* VT,
+                                                       int maxIterations, float convergeCriterion,
+                                                       float flatTolerance, int flatIterations, qint64 deadline,
+                                                       float radius, float height, QString& velField,
+                                                       float& VTsolution, float& Xsolution, float& Ysolution)
 {
+    // A search that stops on a flat wind field or at the deadline (ns on
+    // _volumeTimer, -1 for none) keeps its best vertex. One that runs out
+    // of iterations has no solution.
     VTsolution = Xsolution = Ysolution = 0.0f;
 
     int numIterations = 0;
+    float flatVT = -999.0f;
+    int flatSince = 0;
     int low = 0;
     int mid = 0;
     int high = 0;
@@ -461,31 +1231,49 @@ void SimplexThread::_centerIterate(float** vertex, float* vertexSum, float* VT,
             VTsolution = VT[high];
             Xsolution = vertex[high][0];
             Ysolution = vertex[high][1];
-            break;
+            return Converged;
+        }
+
+        // Stop early once the best wind has stopped improving
+        if (flatTolerance > 0) {
+            if (VT[high] > flatVT + flatTolerance) {
+                flatVT = VT[high];
+                flatSince = numIterations;
+            } else if (numIterations - flatSince >= flatIterations) {
+                VTsolution = VT[high];
+                Xsolution = vertex[high][0];
+                Ysolution = vertex[high][1];
+                return Converged;
+            }
         }
 
         // Check iterations
-        if (numIterations > maxIterations) {
-            emit log(Message(QString("Maximum iterations exceeded in Simplex"),0,this->objectName()));
-            break;
+        if (numIterations > maxIterations)
+            return IterationsExceeded;
+
+        if ((deadline >= 0) && (_volumeTimer.nsecsElapsed() >= deadline)) {
+            VTsolution = VT[high];
+            Xsolution = vertex[high][0];
+            Ysolution = vertex[high][1];
+            return BudgetExceeded;
         }
 
         numIterations += 2;
         // Reflection
-        float VTtest = _simplexTest(vertex, VT, vertexSum, radius, height,RefK, velField, low, -1.0);
+        float VTtest = _simplexTest(ws, vertex, VT, vertexSum, radius, height, velField, low, -1.0);
         if (VTtest >= VT[high])
             // Better point than highest, so try expansion
-            VTtest = _simplexTest(vertex, VT, vertexSum, radius, height,RefK, velField, low, 2.0);
+            VTtest = _simplexTest(ws, vertex, VT, vertexSum, radius, height, velField, low, 2.0);
         else if (VTtest <= VT[mid]) {
             // Worse point than second highest, so try contraction
             float VTsave = VT[low];
-            VTtest = _simplexTest(vertex, VT, vertexSum, radius, height,RefK, velField, low, 0.5);
+            VTtest = _simplexTest(ws, vertex, VT, vertexSum, radius, height, velField, low, 0.5);
             if (VTtest <= VTsave) {
                 for (int v=0; v<=2; v++) {
                     if (v != high) {
                         for (int i=0; i<=1; i++)
                             vertex[v][i] = vertexSum[i] = 0.5*(vertex[v][i] + vertex[high][i]);
-                        VT[v]=_getSymWind(vertex[v][0],vertex[v][1],int(RefK),radius,height,velField);
+                        VT[v]=_getSymWind(ws,vertex[v][0],vertex[v][1],radius,height,velField);
                     }
                 }
                 numIterations += 2;
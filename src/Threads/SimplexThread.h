@@ -14,6 +14,7 @@
 #include <QSize>
 #include <QList>
 #include <QObject>
+#include <QElapsedTimer>
 
 #include "IO/Message.h"
 #include "Config/Configuration.h"
@@ -23,6 +24,7 @@
 #include "DataObjects/SimplexList.h"
 #include "DataObjects/SimplexData.h"
 #include "DataObjects/VortexData.h"
+#include "DataObjects/RingCache.h"
 
 
 class SimplexThread:public QObject
@@ -33,6 +35,8 @@ public:
     SimplexThread(QObject* parent=0);
     ~SimplexThread();
     void initParam(Configuration *wholeConfig, GriddedData *dataPtr,float latGuess, float lonGuess);
+    // 1 sigma error of the first guess in km, -1 if it is not known
+    void setGuessUncertainty(float uncertainty);
     bool findCenter(SimplexList* simplexList);
 
 public slots:
@@ -46,38 +50,128 @@ private:
     Configuration *configData;
     float _latGuess;
     float _lonGuess;
+    float _guessUncertainty;
     float* _dataGaps;
+    int _azimuthSamples;
+    int _ringCacheSize;
+    int _numThreads;
     VTD* _simplexVTD;
     Coefficient* _vtdCoeffs;
-    float* VT;
-    float* vertexSum;
     float firstLevel;
     float lastLevel;
     float firstRing;
     float lastRing;
-    float vtdStdDev;
     float meanXall, meanYall, meanVTall;
     float meanX, meanY, meanVT;
     float stdDevVertexAll, stdDevVTAll;
     float stdDevVertex, stdDevVT;
     float convergingCenters;
-    float endX[25],endY[25],VTind[25];
-    float Xconv[25],Yconv[25],VTconv[25];
-    float startX[25], startY[25];
+    bool  ringBudgetExceeded;
+    QElapsedTimer _volumeTimer;
+    // Per point results of the ring being archived, numpoints long
+    float *endX, *endY, *VTind;
+    float *Xconv, *Yconv, *VTconv;
+    float *startX, *startY;
 
 
+    // _getSymWind results of the search in progress, keyed on the exact
+    // center, radius and height the VTD is given. Two centers in the
+    // same grid cell share a ring (see RingCache) but not a fit, since
+    // the VTD geometry depends on the exact center. The centers of a
+    // refined grid are on the grid before, so grid mode revisits many of
+    // them; a simplex search hardly ever lands on the same center twice,
+    // so the memo is only enabled for grid mode.
+    class WindMemo {
+    public:
+        WindMemo() : _enabled(false), _next(0), _size(0), _hits(0), _misses(0) {}
+        void setEnabled(bool enabled) { _enabled = enabled; }
+        void clear() { _next = _size = 0; }
+        bool find(float x, float y, float radius, float height, float& VT);
+        void insert(float x, float y, float radius, float height, float VT);
+        int  getHits() const   { return _hits; }
+        int  getMisses() const { return _misses; }
+    private:
+        // The oldest entry is overwritten once it is full
+        static const int MAXENTRIES = 256;
+        float _x[MAXENTRIES];
+        float _y[MAXENTRIES];
+        float _radius[MAXENTRIES];
+        float _height[MAXENTRIES];
+        float _VT[MAXENTRIES];
+        bool _enabled;
+        int _next;
+        int _size;
+        int _hits;
+        int _misses;
+    };
+
+    // Everything a simplex search writes to, one per worker thread so
+    // the searches can run side by side. Worker 0 uses _simplexVTD.
+    class Workspace {
+    public:
+        Workspace() : vtd(0), coeffs(0) {}
+        VTD* vtd;
+        Coefficient* coeffs;
+        RingCache ringCache;
+        WindMemo windMemo;
+    };
+
+    // One (level, ring) of the search. Its points are firstPoint on in
+    // the per point arrays of findCenter. A warm job starts from the
+    // previous volume's center seedX, seedY instead of the full box.
+    class RingJob {
+    public:
+        float height;
+        float radius;
+        float cornerI;
+        float cornerJ;
+        bool  inside;
+        bool  warm;
+        float seedX;
+        float seedY;
+        int   firstPoint;
+    };
+
+    // Where the points of a (level, ring) start: a box of numPoints from
+    // the corner of the job, or a smaller one about the seed of a warm job
+    class StartBox {
+    public:
+        float numPoints;
+        float boxRowLength;
+        float boxIncr;
+        float radiusOfInfluence;
+        float warmBoxIncr;
+        float warmRadiusOfInfluence;
+        float influence(const RingJob& job) const;
+        void  start(const RingJob& job, int point, float& RefI, float& RefJ) const;
+    };
+
+    // The ParallelFor tasks of findCenter
+    class InitialTask;
+    class SearchTask;
+    class GridTask;
+
     void archiveCenters(SimplexData* simplexData,float radius,float height,float numPoints);
     void archiveNull(SimplexData* simplexData,float& radius,float& height,float& numPoints);
+    bool _previousCenter(const SimplexData& previous, float height, float radius,
+                         float& seedX, float& seedY);
     inline void _getVertexSum(float** vertex,float* vertexSum);
-    float _simplexTest(float**& vertex, float*& VT, float*& vertexSum,
-                      float& radius, float& height, float& RefK,
+    int   _getRingData(Workspace& ws, float vertex_x, float vertex_y, float radius, float height,
+                       QString& velField, float*& ringData, float*& ringAzimuths);
+    float _simplexTest(Workspace& ws, float**& vertex, float*& VT, float*& vertexSum,
+                      float& radius, float& height,
                       QString& velField, int& high,double factor);
 
     // Choosecenter variables
     float velNull;
-    float _getSymWind(float vertex_x,float vertex_y,int RefK,float radius,float height,QString velField);
-    void  _centerIterate(float** vertex,float* vertexSum, float* VT,int maxIterations,float convergeCriterion,
-                          float RefK,float radius,float height,QString velField,float& VTsolution,float& Xsolution,float& Ysolution);
+    float _getSymWind(Workspace& ws, float vertex_x,float vertex_y,float radius,float height,QString& velField);
+    void  _getSymWinds(Workspace& ws, int numCenters, const float* vertex_x, const float* vertex_y,
+                       float radius, float height, QString& velField, float* VT);
+    // How a simplex search ended
+    enum SearchEnd { Converged, IterationsExceeded, BudgetExceeded };
+    SearchEnd _centerIterate(Workspace& ws, float** vertex,float* vertexSum, float* VT,int maxIterations,float convergeCriterion,
+                             float flatTolerance, int flatIterations, qint64 deadline,
+                             float radius,float height,QString& velField,float& VTsolution,float& Xsolution,float& Ysolution);
 };
 
 #endif
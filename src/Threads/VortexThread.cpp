@@ -11,6 +11,7 @@
 #include <QtGui>
 #include <math.h>
 #include "VortexThread.h"
+#include "Threads/ParallelFor.h"
 #include "DataObjects/Coefficient.h"
 #include "DataObjects/Center.h"
 #include "VTD/VTDFactory.h"
@@ -46,6 +47,9 @@ VortexThread::VortexThread(QObject *parent) : QObject(parent)
     pressureList = NULL;
     configData = NULL;
     dataGaps = NULL;
+    azimuthSamples = 0;
+    numThreads = 0;
+    hvvpFound = false;
 }
 
 VortexThread::~VortexThread()
@@ -69,6 +73,61 @@ void VortexThread::getWinds(Configuration *wholeConfig, GriddedData *dataPtr, Ra
     run();
 }
 
+// Pulls a chunk of the rings about one center out of the grid and fits
+// them in one batch with the worker's own VTD. Splitting every center's
+// rings into chunks gives many more tasks than workers, so the costly
+// low levels do not hold up the pool.
+class VortexThread::RingTask
+{
+public:
+    VortexThread* vortex;
+    VTD** vtds;
+    int numRings;
+    int numChunks;
+    const float* radii;
+    const bool* inside;
+    float* xCenter;
+    float* yCenter;
+    float* height;
+    Coefficient* coeffs;
+    int coeffStride;
+    float* stdDev;
+    bool* valid;
+
+    void operator()(int worker, int task)
+    {
+        int center = task / numChunks;
+        int firstRing = (task % numChunks) * ringsPerTask;
+        int chunkRings = numRings - firstRing;
+        if (chunkRings > ringsPerTask)
+            chunkRings = ringsPerTask;
+        int first = center * numRings + firstRing;
+        for (int n = 0; n < chunkRings; n++)
+            valid[first + n] = false;
+        if (!inside[center])
+            return;
+
+        Coefficient* chunkCoeffs = coeffs + first * coeffStride;
+        for (int c = 0; c < chunkRings * coeffStride; c++)
+            chunkCoeffs[c] = Coefficient();
+
+        int* ringOffset = new int[chunkRings];
+        int* ringLength = new int[chunkRings];
+        float* ringData;
+        float* ringAzimuths;
+        vortex->getLevelRings(xCenter[center], yCenter[center], height[center], chunkRings,
+                              radii + firstRing, ringOffset, ringLength, ringData, ringAzimuths);
+        vtds[worker]->analyzeRings(xCenter[center], yCenter[center], height[center],
+                                   chunkRings, radii + firstRing, ringOffset, ringLength,
+                                   ringData, ringAzimuths, chunkCoeffs, coeffStride,
+                                   stdDev + first, valid + first);
+        delete[] ringData;
+        delete[] ringAzimuths;
+        delete[] ringOffset;
+        delete[] ringLength;
+    }
+};
+
 void VortexThread::run()
 {
     // Initialize variables
@@ -98,10 +157,16 @@ void VortexThread::run()
 
     // Create a {GB|G}VTD object to process the rings
 
+    // The HVVP wind only depends on the volume and the center, so it is
+    // found once here for every level and for calcPressureUncertainty
+
     hvvpResult = 0.0;
+    hvvpUncertainty = 0.0;
+    hvvpFound = false;
 
     if (closure.contains(QString("hvvp"), Qt::CaseInsensitive)) {
-      if ( ! calcHVVP(true))
+      hvvpFound = calcHVVP(true);
+      if ( ! hvvpFound)
 	emit log(Message(QString(),5,this->objectName(),Yellow,QString("Could Not Retrieve HVVP Wind")));
     }
     else {
@@ -110,29 +175,47 @@ void VortexThread::run()
 
     vtd = VTDFactory::createVTD(geometry, closure, maxWave, dataGaps,
 				hvvpResult);
-    Coefficient* vtdCoeffs = new Coefficient[20];
-
-    // Placeholders for centers
-
-    float xCenter = -999;
-    float yCenter = -999;
-
-    // TODO 7.0?
+    vtd->setFixedAzimuths(azimuthSamples > 0);
 
-    // int loopPercent = int(7.0 / float(gridData->getKdim()));
-    // int endPercent = 7 - int(gridData->getKdim() * loopPercent);
-    int storageIndex = -1;
+    // Every level analyzes the same rings, with the results for ring n
+    // of level l in the slot (l * numRings + n)
+    int numRings = 0;
+    for (float radius = firstRing; radius <= lastRing; radius++)
+        numRings++;
+    float* ringRadii = new float[numRings];
+    for (int n = 0; n < numRings; n++)
+        ringRadii[n] = firstRing + n;
 
     float kGridSpacing = gridData->getKGridsp();
 
     // How do I get simplexData->getNumLevels() from here?
     int maxIndex = (int) floor( (lastLevel - firstLevel) / kGridSpacing + 1.5);
 
-    for(storageIndex = 0; storageIndex < maxIndex; storageIndex++) {
+    int numSlots = maxIndex * numRings;
+    const int coeffStride = 20;
+    bool* levelInside = new bool[maxIndex];
+    float* levelX = new float[maxIndex];
+    float* levelY = new float[maxIndex];
+    float* levelHeight = new float[maxIndex];
+    float* ringStdDev = new float[numSlots];
+    bool* ringValid = new bool[numSlots];
+    Coefficient* ringCoeffs = new Coefficient[numSlots * coeffStride];
+
+    // The reference point of the grid is shared, so the centers are
+    // placed one level at a time before any thread starts
+
+    // compute crossbeam wind to correct GBVTD result
+
+    float rt, cca;
+    getRadarDistance(rt, cca);
+
+    for(int storageIndex = 0; storageIndex < maxIndex; storageIndex++) {
 
         float referenceLat = vortexData->getLat(storageIndex);
         float referenceLon = vortexData->getLon(storageIndex);
 	float height = firstLevel + storageIndex * kGridSpacing;
+        levelInside[storageIndex] = false;
+        levelHeight[storageIndex] = height;
 #if 0
 	std::cout << "storageIndex: " << storageIndex << ", lat: " << referenceLat
 		  << ", lon: " << referenceLon << ", height: " << height << std::endl;
@@ -150,46 +233,31 @@ void VortexThread::run()
             continue;
         }
 
-        // compute crossbeam wind to correct GBVTD result
-
-        int gradientIndex = heightToIndex(gradientHeight);
-        QDomElement radar = configData->getConfig("radar");
-        float radarLat = configData->getParam(radar,"lat").toFloat();
-        float radarLon = configData->getParam(radar,"lon").toFloat();
-        float vortexLat = vortexData->getLat(gradientIndex);
-        float vortexLon = vortexData->getLon(gradientIndex);
-
-        float* distance = gridData->getCartesianPoint(&radarLat, &radarLon, &vortexLat, &vortexLon);
-        float rt = sqrt(distance[0]*distance[0]+distance[1]*distance[1]);
-        float cca = atan2(distance[0], distance[1])*180/acos(-1);
-        delete [] distance;
-
-        Hvvp *hvvp = new Hvvp;
-        hvvp->setConfig(configData);
-        hvvp->setRadarData(radarVolume, rt, cca, vortexData->getAveRMW());
+        // Get the cartesian points
+        levelInside[storageIndex] = true;
+        levelX[storageIndex] = gridData->getCartesianRefPointI();
+        levelY[storageIndex] = gridData->getCartesianRefPointJ();
+    }
 
-	float Vm = 0.0;
+    fitRings(maxIndex, levelInside, levelX, levelY, levelHeight, numRings, ringRadii,
+             ringCoeffs, coeffStride, ringStdDev, ringValid);
 
-        // should we be incrementing radius using ringwidth? -LM
-        for (float radius = firstRing; radius <= lastRing; radius++) {
-            // Get the cartesian points
-            xCenter = gridData->getCartesianRefPointI();
-            yCenter = gridData->getCartesianRefPointJ();
+    // Archive in level and ring order, as a single thread would
+    float Vm = 0.0;
+    for(int storageIndex = 0; storageIndex < maxIndex; storageIndex++) {
+        if (!levelInside[storageIndex])
+            continue;
+	float height = firstLevel + storageIndex * kGridSpacing;
 
-            // Get the data
-            int numData = gridData->getCylindricalAzimuthLength(radius, height);
-            float* ringData = new float[numData];
-            float* ringAzimuths = new float[numData];
-            gridData->getCylindricalAzimuthData(velField, numData, radius, height, ringData);
-            gridData->getCylindricalAzimuthPosition(numData, radius, height, ringAzimuths);
-
-            // Call gbvtd
-            if (vtd->analyzeRing(xCenter, yCenter, radius, height, numData, ringData,
-                                 ringAzimuths, vtdCoeffs, vtdStdDev)) {
-                if (vtdCoeffs[0].getParameter() == "VTC0") {
-                    // VT[v] = vtdCoeffs[0].getValue();
-                    if(vtdCoeffs[0].getValue() != -999.f){
-                        vtdCoeffs[0].setValue( vtdCoeffs[0].getValue()-Vm*radius/rt );
+        for (int n = 0; n < numRings; n++) {
+            float radius = ringRadii[n];
+            int slot = storageIndex * numRings + n;
+            Coefficient* coeffs = ringCoeffs + slot * coeffStride;
+            if (ringValid[slot]) {
+                if (coeffs[0].getId() == Coefficient::VTC0) {
+                    // VT[v] = coeffs[0].getValue();
+                    if(coeffs[0].getValue() != -999.f){
+                        coeffs[0].setValue( coeffs[0].getValue()-Vm*radius/rt );
                     }
                 } else {
                     emit log(Message(QString("Error retrieving VTC0 in vortex!"),0,this->objectName(), Yellow));
@@ -203,17 +271,18 @@ void VortexThread::run()
                 emit log(Message(err));
             }
 
-            delete[] ringData;
-            delete[] ringAzimuths;
-
             // All done with this radius and height, archive it
-            archiveWinds(radius, storageIndex, maxCoeffs, vtdCoeffs);
+            archiveWinds(radius, storageIndex, maxCoeffs, coeffs);
         }
     }
     emit log(Message(QString(),15,this->objectName()));
 
     // Clean up
     delete vtd;
+    delete[] levelInside;
+    delete[] levelX;
+    delete[] levelY;
+    delete[] levelHeight;
 
     // Integrate the winds to get the pressure deficit at the 2nd level (presumably 2km)
     // Gradient height is in km
@@ -234,7 +303,10 @@ void VortexThread::run()
     // Get the estimated surface wind
     getMaxSfcWind(vortexData);
 
-    delete [] vtdCoeffs;
+    delete [] ringRadii;
+    delete [] ringStdDev;
+    delete [] ringValid;
+    delete [] ringCoeffs;
     delete [] pressureDeficit;
 }
 
@@ -245,7 +317,7 @@ void VortexThread::archiveWinds(float radius, int hIndex, int maxCoeffs, Coeffic
     int ring = int(radius - firstRing);
 
     for (int coeff = 0; coeff < maxCoeffs; coeff++) {
-        vortexData->setCoefficient(level, ring, coeff, vtdCoeffs[coeff]);
+        vortexData->setCoefficient(level, ring, vtdCoeffs[coeff]);
         Coefficient current = vtdCoeffs[coeff];
 
 	// DEBUG
@@ -268,7 +340,7 @@ void VortexThread::archiveWinds(VortexData& data, float& radius, int& hIndex, in
     int ring = int(radius - firstRing);
 
     for (int coeff = 0; coeff < maxCoeffs; coeff++) {
-        data.setCoefficient(level, ring, coeff, vtdCoeffs[coeff]);
+        data.setCoefficient(level, ring, vtdCoeffs[coeff]);
     }
 }
 
@@ -292,9 +364,9 @@ void VortexThread::getPressureDeficit(VortexData* data, float* pDeficit,const fl
     float f = 2 * 7.29e-5 * sin(data->getLat(heightIndex) * 3.141592653589793238462643 / 180.);
 
     for (float radius = firstRing; radius <= lastRing; radius++) {
-      // if (!(data->getCoefficient(height, radius, QString("VTC0")) == Coefficient())) {
-      if ( (data->getCoefficient(height, radius, QString("VTC0"))).isValid()) {
-            float meanVT = data->getCoefficient(height, radius, QString("VTC0")).getValue();
+      // if (!(data->getCoefficient(height, radius, Coefficient::VTC0) == Coefficient())) {
+      if ( (data->getCoefficient(height, radius, Coefficient::VTC0)).isValid()) {
+            float meanVT = data->getCoefficient(height, radius, Coefficient::VTC0).getValue();
             if (meanVT != 0) {
                 dpdr[(int)radius] = ((f * meanVT) + (meanVT * meanVT)/(radius * deltar)) * rhoBar[ (int) height - 1];
             }
@@ -358,9 +430,8 @@ void VortexThread::calcCentralPressure(VortexData* vortex, float* pD, float heig
                 float vortexLon = vortex->getLon(heightIndex);
                 float obLat = pressureList->at(i).getLat();
                 float obLon = pressureList->at(i).getLon();
-                float* relDist = gridData->getCartesianPoint(&vortexLat, &vortexLon,&obLat, &obLon);
-                float obRadius = sqrt(relDist[0]*relDist[0] + relDist[1]*relDist[1]);
-                delete [] relDist;
+                CartesianPoint relDist = gridData->getCartesianPoint(&vortexLat, &vortexLon,&obLat, &obLon);
+                float obRadius = sqrt(relDist.x*relDist.x + relDist.y*relDist.y);
                 if ((obRadius >= 20) and (obRadius <= maxObRadius)) {
                 //if ((obRadius >= vortex->getRMW(heightIndex)) and (obRadius <= maxObRadius)) {
                     // Good ob anchor!
@@ -446,12 +517,11 @@ void VortexThread::calcPressureUncertainty(float setLimit, QString nameAddition)
     int numErrorPoints = 4;
     float angle = 2 * acos(-1) / numErrorPoints;
 
-    // Create a {GB|G}VTD object to process the rings
-
-    hvvpResult = 0.0;
+    // Create a {GB|G}VTD object to process the rings, with the HVVP
+    // wind run() found for this volume
 
     if(closure.contains(QString("hvvp"), Qt::CaseInsensitive)) {
-      if( ! calcHVVP(false)) {
+      if( ! hvvpFound) {
 	emit log(Message(QString(), 0, this->objectName(), Yellow,
 			 QString("Could Not Retrieve HVVP Wind")));
         }
@@ -461,23 +531,38 @@ void VortexThread::calcPressureUncertainty(float setLimit, QString nameAddition)
 
     vtd = VTDFactory::createVTD(geometry, closure, maxWave, dataGaps,
 				hvvpResult);
-
-    Coefficient* vtdCoeffs = new Coefficient[20];
+    vtd->setFixedAzimuths(azimuthSamples > 0);
+
+    int numRings = 0;
+    for (float radius = firstRing; radius <= lastRing; radius++)
+        numRings++;
+    float* ringRadii = new float[numRings];
+    for (int n = 0; n < numRings; n++)
+        ringRadii[n] = firstRing + n;
+    int numSlots = numErrorPoints * numRings;
+    float* ringStdDev = new float[numSlots];
+    bool* ringValid = new bool[numSlots];
+    const int coeffStride = 20;
+    Coefficient* ringCoeffs = new Coefficient[numSlots * coeffStride];
+    bool* pointInside = new bool[numErrorPoints];
+    float* pointX = new float[numErrorPoints];
+    float* pointY = new float[numErrorPoints];
+    float* pointHeight = new float[numErrorPoints];
     VortexList errorVertices;
     float refLat = vortexData->getLat(goodLevel);
     float refLon = vortexData->getLon(goodLevel);
     float sqDeficitSum = 0;
 
+    // Place the error vertices on the grid one at a time, as the reference
+    // point is shared. fitRings then spreads the (vertex, ring chunk) fits
+    // over the thread pool.
     for(int p = 0; p < numErrorPoints; p++) {
-        VortexData* errorVertex = new VortexData(1, vortexData->getNumRadii(), vortexData->getNumWaveNum());
-        errorVertex->setTime(vortexData->getTime().addDays(p).addYears(2));
-        errorVertex->setHeight(0, vortexData->getHeight(goodLevel));
-        // Set the reference point
-        float* newLatLon = gridData->getAdjustedLatLon(refLat, refLon,
+        LatLon newLatLon = gridData->getAdjustedLatLon(refLat, refLon,
 						       centerStd * cos(p * angle),
 						       centerStd * sin(p * angle));
-        gridData->setAbsoluteReferencePoint(newLatLon[0], newLatLon[1], height);
-        delete  [] newLatLon;
+        gridData->setAbsoluteReferencePoint(newLatLon.lat, newLatLon.lon, height);
+        pointInside[p] = false;
+        pointHeight[p] = height;
 
         if ((gridData->getRefPointI() < 0) || (gridData->getRefPointJ() < 0) || (gridData->getRefPointK() < 0)) {
             // Out of bounds problem
@@ -485,32 +570,34 @@ void VortexThread::calcPressureUncertainty(float setLimit, QString nameAddition)
             continue;
         }
 
-        for (float radius = firstRing; radius <= lastRing; radius++) {
-            // Get the cartesian points
-            float xCenter = gridData->getCartesianRefPointI();
-            float yCenter = gridData->getCartesianRefPointJ();
-
-            // Get the data
-            int numData = gridData->getCylindricalAzimuthLength(radius, height);
-            float* ringData = new float[numData];
-            float* ringAzimuths = new float[numData];
-
-            gridData->getCylindricalAzimuthData(velField, numData, radius, height, ringData);
-            gridData->getCylindricalAzimuthPosition(numData, radius, height, ringAzimuths);
+        // Get the cartesian points
+        pointInside[p] = true;
+        pointX[p] = gridData->getCartesianRefPointI();
+        pointY[p] = gridData->getCartesianRefPointJ();
+    }
 
-            // Call gbvtd
-            if (vtd->analyzeRing(xCenter, yCenter, radius, height, numData, ringData, ringAzimuths, vtdCoeffs, vtdStdDev)) {
-                if (vtdCoeffs[0].getParameter() != "VTC0") {
-                    emit log(Message(QString("CalcPressureUncertainty:Error retrieving VTC0 in vortex!"), 0, this->objectName()));
-                }
+    fitRings(numErrorPoints, pointInside, pointX, pointY, pointHeight, numRings, ringRadii,
+             ringCoeffs, coeffStride, ringStdDev, ringValid);
 
-                // All done with this radius and height, archive it
-                archiveWinds(*errorVertex, radius, goodLevel, maxCoeffs, vtdCoeffs);
+    // The pressure of each vertex, in order
+    for(int p = 0; p < numErrorPoints; p++) {
+        if (!pointInside[p])
+            continue;
+        VortexData* errorVertex = new VortexData(1, vortexData->getNumRadii(), vortexData->getNumWaveNum());
+        errorVertex->setTime(vortexData->getTime().addDays(p).addYears(2));
+        errorVertex->setHeight(0, vortexData->getHeight(goodLevel));
 
-                // Clean up
-                delete[] ringData;
-                delete[] ringAzimuths;
+        for (int n = 0; n < numRings; n++) {
+            int slot = p * numRings + n;
+            if (!ringValid[slot])
+                continue;
+            Coefficient* coeffs = ringCoeffs + slot * coeffStride;
+            if (coeffs[0].getId() != Coefficient::VTC0) {
+                emit log(Message(QString("CalcPressureUncertainty:Error retrieving VTC0 in vortex!"), 0, this->objectName()));
             }
+
+            // All done with this radius and height, archive it
+            archiveWinds(*errorVertex, ringRadii[n], goodLevel, maxCoeffs, coeffs);
         }
         // Now calculate central pressure for each of these
         float* errorPressureDeficit = new float[(int)lastRing + 1];
@@ -535,9 +622,8 @@ void VortexThread::calcPressureUncertainty(float setLimit, QString nameAddition)
                 float vortexLon = errorVertex->getLon(0);
                 float obLat = _presObs[j].getLat();
                 float obLon = _presObs[j].getLon();
-                float* relDist = gridData->getCartesianPoint(&vortexLat, &vortexLon, &obLat, &obLon);
-                float obRadius = sqrt(relDist[0] * relDist[0] + relDist[1] * relDist[1]);
-                delete [] relDist;
+                CartesianPoint relDist = gridData->getCartesianPoint(&vortexLat, &vortexLon, &obLat, &obLon);
+                float obRadius = sqrt(relDist.x * relDist.x + relDist.y * relDist.y);
                 float pPrimeOuter;
                 if (obRadius >= lastRing) {
                     pPrimeOuter = errorPressureDeficit[(int)lastRing];
@@ -554,7 +640,14 @@ void VortexThread::calcPressureUncertainty(float setLimit, QString nameAddition)
         delete errorVertex;
     }
 
-    delete[] vtdCoeffs;
+    delete[] ringRadii;
+    delete[] ringStdDev;
+    delete[] ringValid;
+    delete[] ringCoeffs;
+    delete[] pointInside;
+    delete[] pointX;
+    delete[] pointY;
+    delete[] pointHeight;
     delete vtd;
 
     // Standard deviation from the center point
@@ -606,6 +699,10 @@ void VortexThread::readInConfig()
 {
     QDomElement vtdConfig = configData->getConfig("vtd");
     QDomElement pressureConfig = configData->getConfig("pressure");
+    QDomElement radarConfig = configData->getConfig("radar");
+
+    radarLat = configData->getParam(radarConfig,"lat").toFloat();
+    radarLon = configData->getParam(radarConfig,"lon").toFloat();
 
     vortexPath = configData->getParam(vtdConfig,QString("dir"));
     geometry = configData->getParam(vtdConfig,QString("geometry"));
@@ -628,6 +725,16 @@ void VortexThread::readInConfig()
         dataGaps[i] = configData->getParam(vtdConfig, QString("maxdatagap"), QString("wavenum"),QString().setNum(i)).toFloat();
     }
 
+    // Optionally resample each ring to a fixed number of azimuths
+    QString samplesConfig = configData->getParam(vtdConfig, QString("azimuthsamples"));
+    if(samplesConfig != "")
+        azimuthSamples = samplesConfig.toInt();
+
+    // The rings are fitted on this many threads, 0 for one per core
+    QString threadsConfig = configData->getParam(vtdConfig, QString("threads"));
+    if(threadsConfig != "")
+        numThreads = threadsConfig.toInt();
+
     // Set GriddedData to use ringwidth for spacing
     gridData->setCylindricalAzimuthSpacing(ringWidth);
 
@@ -656,6 +763,99 @@ void VortexThread::readInConfig()
     envPressure = -999;
 }
 
+int VortexThread::getLevelRings(float xCenter, float yCenter, float height, int numRings,
+                                const float* radii, int* ringOffset, int* ringLength,
+                                float*& ringData, float*& ringAzimuths)
+{
+    // Pull out every ring of the level around (xCenter, yCenter) into one
+    // block, ring n starting at ringOffset[n]. The reference point of the
+    // grid is not used, so levels can be pulled out on several threads.
+    // The caller owns the returned arrays.
+
+    int total = 0;
+    if(azimuthSamples > 0) {
+        total = numRings * azimuthSamples;
+        ringData = new float[total];
+        ringAzimuths = new float[total];
+        for(int n = 0; n < numRings; n++) {
+            ringOffset[n] = n * azimuthSamples;
+            ringLength[n] = azimuthSamples;
+            gridData->getCylindricalAzimuthSamples(velField, xCenter, yCenter, azimuthSamples,
+                                                   radii[n], height, ringData + ringOffset[n],
+                                                   ringAzimuths + ringOffset[n]);
+        }
+        return total;
+    }
+
+    total = gridData->getCylindricalAnnulusLength(xCenter, yCenter, numRings, radii, height,
+                                                  ringLength);
+    for(int n = 0; n < numRings; n++)
+        ringOffset[n] = (n == 0) ? 0 : ringOffset[n - 1] + ringLength[n - 1];
+    ringData = new float[total];
+    ringAzimuths = new float[total];
+    gridData->getCylindricalAnnulusData(velField, xCenter, yCenter, numRings, radii, height,
+                                        ringOffset, ringData, ringAzimuths);
+    return total;
+}
+
+void VortexThread::fitRings(int numCenters, const bool* inside, float* xCenter,
+                            float* yCenter, float* height, int numRings,
+                            const float* radii, Coefficient* coeffs, int coeffStride,
+                            float* stdDev, bool* valid)
+{
+    // Fits every ring about each center that is inside the grid, using
+    // vtd. Ring n of center c goes to the slot (c * numRings + n), with
+    // its coefficients at coeffs[slot * coeffStride]. Each center's rings
+    // are cut into chunks of ringsPerTask, every chunk is pulled out and
+    // solved together by VTD::analyzeRings, and the chunks are spread over
+    // the thread pool, every worker with its own VTD. A chunk's slots are
+    // only written by the thread that fits it, so the results do not
+    // depend on the number of threads.
+
+    int numChunks = (numRings + ringsPerTask - 1) / ringsPerTask;
+    int numTasks = numCenters * numChunks;
+    int numWorkers = ParallelFor::workers(numTasks, numThreads);
+    VTD** vtds = new VTD*[numWorkers];
+    for (int w = 0; w < numWorkers; w++)
+        vtds[w] = (w == 0) ? vtd : vtd->clone();
+
+    RingTask ringTask;
+    ringTask.vortex = this;
+    ringTask.vtds = vtds;
+    ringTask.numRings = numRings;
+    ringTask.numChunks = numChunks;
+    ringTask.radii = radii;
+    ringTask.inside = inside;
+    ringTask.xCenter = xCenter;
+    ringTask.yCenter = yCenter;
+    ringTask.height = height;
+    ringTask.coeffs = coeffs;
+    ringTask.coeffStride = coeffStride;
+    ringTask.stdDev = stdDev;
+    ringTask.valid = valid;
+    ParallelFor::run(numTasks, numWorkers, ringTask);
+
+    // vtd itself belongs to the caller
+    for (int w = 1; w < numWorkers; w++)
+        delete vtds[w];
+    delete[] vtds;
+}
+
+void VortexThread::getRadarDistance(float& rt, float& cca)
+{
+    // Range (km) and meteorological azimuth (degrees) from the radar to
+    // the center at the gradient height
+    int gradientIndex = heightToIndex(gradientHeight);
+    float vortexLat = vortexData->getLat(gradientIndex);
+    float vortexLon = vortexData->getLon(gradientIndex);
+
+    CartesianPoint distance;
+    distance = gridData->getCartesianPoint(&radarLat, &radarLon,
+                                           &vortexLat, &vortexLon);
+    rt = sqrt(distance.x * distance.x + distance.y  *distance.y);
+    cca = atan2(distance.x, distance.y) * 180 / acos(-1);
+}
+
 bool VortexThread::calcHVVP(bool printOutput)
 {
     // Get environmental wind
@@ -670,18 +870,10 @@ bool VortexThread::calcHVVP(bool printOutput)
    */
 
     int gradientIndex = heightToIndex(gradientHeight);
-    QDomElement radar = configData->getConfig("radar");
-    float radarLat = configData->getParam(radar,"lat").toFloat();
-    float radarLon = configData->getParam(radar,"lon").toFloat();
     float vortexLat = vortexData->getLat(gradientIndex);
     float vortexLon = vortexData->getLon(gradientIndex);
-
-    float* distance;
-    distance = gridData->getCartesianPoint(&radarLat, &radarLon,
-                                           &vortexLat, &vortexLon);
-    float rt = sqrt(distance[0] * distance[0] + distance[1]  *distance[1]);
-    float cca = atan2(distance[0], distance[1]) * 180 / acos(-1);
-    delete [] distance;
+    float rt, cca;
+    getRadarDistance(rt, cca);
 
     if(printOutput) {
         //Message::toScreen("Vortex (Lat,Lon): ("+QString().setNum(vortexLat)+", "+QString().setNum(vortexLon)+")");
@@ -759,14 +951,14 @@ void VortexThread::getMaxSfcWind(VortexData* data)
 	    // float centerDistance = sqrt(xCenter * xCenter + yCenter * yCenter);
 
             // Get the winds
-	    // if (!(data->getCoefficient(height, radius, QString("VTC0")) == Coefficient())) {
-	    if ( (data->getCoefficient(height, radius, QString("VTC0"))).isValid()) {
-
-	      float vtc0 = data->getCoefficient(height, radius, QString("VTC0")).getValue();
-	      float vrc0 = data->getCoefficient(height, radius, QString("VRC0")).getValue();
-	      float vmc0 = data->getCoefficient(height, radius, QString("VMC0")).getValue();
-	      float vtc1 = data->getCoefficient(height, radius, QString("VTC1")).getValue();
-	      float vts1 = data->getCoefficient(height, radius, QString("VTS1")).getValue();
+	    // if (!(data->getCoefficient(height, radius, Coefficient::VTC0) == Coefficient())) {
+	    if ( (data->getCoefficient(height, radius, Coefficient::VTC0)).isValid()) {
+
+	      float vtc0 = data->getCoefficient(height, radius, Coefficient::VTC0).getValue();
+	      float vrc0 = data->getCoefficient(height, radius, Coefficient::VRC0).getValue();
+	      float vmc0 = data->getCoefficient(height, radius, Coefficient::VMC0).getValue();
+	      float vtc1 = data->getCoefficient(height, radius, Coefficient::VTC1).getValue();
+	      float vts1 = data->getCoefficient(height, radius, Coefficient::VTS1).getValue();
 	      double PI = acos(-1.0);
 
 	      for (int i = 0; i < 360; i++) {
@@ -69,16 +69,20 @@ class VortexThread : public QObject
      float lastRing;
      float ringWidth;
      int maxWave;
+     int azimuthSamples;
+     int numThreads;
      float maxObRadius;
      float maxObTimeDiff;
      float hvvpResult;
      float hvvpUncertainty;
+     bool hvvpFound;
+     float radarLat;
+     float radarLon;
      float envPressure;
      float outerRadius;
      int numEstimates;
      QList<PressureData> _presObs;
 
-     float vtdStdDev;
      float convergingCenters;
      float rhoBar[16];
 
@@ -91,7 +95,20 @@ class VortexThread : public QObject
      void calcPressureUncertainty(float setLimit, QString nameAddition);
      void storePressureUncertaintyData(QString& fileLocation);
      void readInConfig();
+     int  getLevelRings(float xCenter, float yCenter, float height, int numRings,
+                        const float* radii, int* ringOffset, int* ringLength,
+                        float*& ringData, float*& ringAzimuths);
+     void fitRings(int numCenters, const bool* inside, float* xCenter,
+                   float* yCenter, float* height, int numRings,
+                   const float* radii, Coefficient* coeffs, int coeffStride,
+                   float* stdDev, bool* valid);
+
+     // The ParallelFor task of fitRings, and how many of a center's rings
+     // each task fits
+     class RingTask;
+     static const int ringsPerTask = 4;
      bool calcHVVP(bool printOutput);
+     void getRadarDistance(float& rt, float& cca);
      void getMaxSfcWind(VortexData* data);
      float fixAngle(float& angle);
 
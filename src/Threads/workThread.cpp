@@ -26,6 +26,7 @@ workThread::workThread(QObject *parent)
 	dataSource= NULL;
 	pressureSource= NULL;
 	configData= NULL;
+	_firstGuessUncertainty = -1;
 }
 
 workThread::~workThread()
@@ -516,6 +517,7 @@ void workThread::_latlonFirstGuess(RadarData* radarVolume)
 {
   QString mode = configData->getParam(configData->getConfig("vortex"),"mode");
   QDateTime volDateTime = radarVolume->getDateTime();
+  _firstGuessUncertainty = -1;
 
   if (mode == "operational") {
     _firstGuessLat = atcf->getLatitude(volDateTime);
@@ -567,9 +569,9 @@ void workThread::_latlonFirstGuess(RadarData* radarVolume)
   float distanceMoved = elapsedSeconds*stormSpd / 1000.0;
   float changeInX = distanceMoved * cos(stormDir);
   float changeInY = distanceMoved * sin(stormDir);
-  float *extrapLatLon = GriddedData::getAdjustedLatLon(initLat, initLon, changeInX, changeInY);
-  _firstGuessLat = extrapLatLon[0];
-  _firstGuessLon = extrapLatLon[1];
+  LatLon extrapLatLon = GriddedData::getAdjustedLatLon(initLat, initLon, changeInX, changeInY);
+  _firstGuessLat = extrapLatLon.lat;
+  _firstGuessLon = extrapLatLon.lon;
 
   // if there is a vortex result,try to extrapolation from this record
 
@@ -593,18 +595,42 @@ void workThread::_latlonFirstGuess(RadarData* radarVolume)
     float changeInX = distanceMoved*cos(stormDir);
     float changeInY = distanceMoved*sin(stormDir);
 
-    float *newLatLon = GriddedData::getAdjustedLatLon(vortexLat, vortexLon, changeInX, changeInY);
-    float relDist = GriddedData::getCartesianDistance(extrapLatLon[0], extrapLatLon[1], newLatLon[0], newLatLon[1]);
+    LatLon newLatLon = GriddedData::getAdjustedLatLon(vortexLat, vortexLon, changeInX, changeInY);
+
+    // Optionally track the centers with a Kalman filter instead, which
+    // also tells how far off its estimate is likely to be
+    float trackUncertainty = -1;
+    if ("true" == configData->getParam(configData->getConfig("vortex"), "kalman")) {
+      QDomElement vortexCfg = configData->getConfig("vortex");
+      float fixError = 2.0;
+      float motionNoise = 5.0;
+      if (configData->getParam(vortexCfg, "fixerror") != "")
+	fixError = configData->getParam(vortexCfg, "fixerror").toFloat();
+      if (configData->getParam(vortexCfg, "motionnoise") != "")
+	motionNoise = configData->getParam(vortexCfg, "motionnoise").toFloat();
+      _tracker.setNoise(fixError, motionNoise);
+      _tracker.setInitialMotion(configData->getParam(vortexCfg, "speed").toFloat(),
+				configData->getParam(vortexCfg, "direction").toFloat());
+      _tracker.update(_vortexList);
+      float trackLat, trackLon;
+      if (_tracker.predict(volDateTime, trackLat, trackLon, trackUncertainty)) {
+	newLatLon.lat = trackLat;
+	newLatLon.lon = trackLon;
+      } else {
+	trackUncertainty = -1;
+      }
+    }
+
+    float relDist = GriddedData::getCartesianDistance(extrapLatLon.lat, extrapLatLon.lon, newLatLon.lat, newLatLon.lon);
 
     if (relDist < 10 || usrDateTime.secsTo(volDateTime) > 60*60) {
-      _firstGuessLat = newLatLon[0];
-      _firstGuessLon = newLatLon[1];
+      _firstGuessLat = newLatLon.lat;
+      _firstGuessLon = newLatLon.lon;
+      _firstGuessUncertainty = trackUncertainty;
       //std::cout<<"Using estimation of center ("<<_firstGuessLat<<","<<_firstGuessLon<<") from last vortex"<<std::endl;
     }
-    delete [] newLatLon;
 
   }
-  delete [] extrapLatLon;
 }
 
 bool workThread::findCenter(RadarData *radar_data, GriddedData *grid_data, float bottom_level, VortexData **vortex_data, int *best_level)
@@ -622,6 +648,7 @@ bool workThread::findCenter(RadarData *radar_data, GriddedData *grid_data, float
 
   SimplexThread* pSimplex = new SimplexThread();
   pSimplex->initParam(configData, grid_data, _firstGuessLat, _firstGuessLon);
+  pSimplex->setGuessUncertainty(_firstGuessUncertainty);
 
   // TODO this does the work.
   // We get "Center Not Found" if we pick a center bottom_level too low in the config file.
@@ -810,13 +837,12 @@ void workThread::updateCappiDisplayInfo(GriddedData *grid_data, VortexData *vort
 
   int bestLevel = vortex_data->getBestLevel();
 
-  float* xyValues = grid_data->getCartesianPoint(&radar_lat, &radar_lon, &simplex_lat, &simplex_lon);
-  float xPercent = float(grid_data->getIndexFromCartesianPointI(xyValues[0])+1)/grid_data->getIdim();
-  float yPercent = float(grid_data->getIndexFromCartesianPointJ(xyValues[1])+1)/grid_data->getJdim();
+  CartesianPoint xyValues = grid_data->getCartesianPoint(&radar_lat, &radar_lon, &simplex_lat, &simplex_lon);
+  float xPercent = float(grid_data->getIndexFromCartesianPointI(xyValues.x)+1)/grid_data->getIdim();
+  float yPercent = float(grid_data->getIndexFromCartesianPointJ(xyValues.y)+1)/grid_data->getJdim();
   float rmwEstimate = vortex_data->getRMW(bestLevel)/(grid_data->getIGridsp()*grid_data->getIdim());
   float sMin = configData->getParam(simplex, "innerradius").toFloat()/(grid_data->getIGridsp()*grid_data->getIdim());
   float sMax = configData->getParam(simplex, "outerradius").toFloat()/(grid_data->getIGridsp()*grid_data->getIdim());
   float vMax = configData->getParam(vtd, "outerradius").toFloat()/(grid_data->getIGridsp()*grid_data->getIdim());
   emit newCappiInfo(xPercent, yPercent, rmwEstimate, sMin, sMax, vMax, radar_lat, radar_lon, simplex_lat, simplex_lon);
-  delete [] xyValues;
 }
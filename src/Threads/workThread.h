@@ -21,6 +21,7 @@
 #include "Config/Configuration.h"
 #include "DataObjects/VortexList.h"
 #include "DataObjects/SimplexList.h"
+#include "DataObjects/VortexTracker.h"
 #include "DataObjects/CappiGrid.h"
 #include "Pressure/PressureFactory.h"
 #include "Pressure/PressureList.h"
@@ -82,6 +83,8 @@ private:
 
     float _firstGuessLat;
     float _firstGuessLon;
+    float _firstGuessUncertainty;     // km, -1 if unknown
+    VortexTracker _tracker;
     
     void _latlonFirstGuess(RadarData* radarVolume);
     void checkIntensification();
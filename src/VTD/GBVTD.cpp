@@ -22,27 +22,40 @@ GBVTD::~GBVTD()
 {
 }
 
+VTD* GBVTD::clone() const
+{
+  QString cloneClosure = closure;
+  int waveNumbers = _maxWaveNum;
+  float* gaps = dataGaps;
+  GBVTD* copy = new GBVTD(cloneClosure, waveNumbers, gaps, _hvvpMean);
+  copy->setFixedAzimuths(_fixedAzimuths);
+  return copy;
+}
+
 bool GBVTD::analyzeRing(float& xCenter, float& yCenter, float& radius, float& height, int& numData, 
                         float*& ringData, float*& ringAzimuths, Coefficient*& vtdCoeffs, float& vtdStdDev)
 {
   // Analyze a ring of data
   
-  // Make a Psi array
-  ringPsi = new float[numData];
-  vel = new float[numData];
-  psi = new float[numData];
+  // Make sure the workspace can hold the ring, no-op once it's big enough
+  reserveWorkspace(numData);
 
   // Get thetaT
   thetaT = atan2(yCenter,xCenter);
   thetaT = fixAngle(thetaT);
   centerDistance = sqrt(xCenter*xCenter + yCenter*yCenter);
 
+  // The cos and sin of angle + thetaT, which is just the azimuth
+  const float* cosAzimuth;
+  const float* sinAzimuth;
+  ringTrig(numData, ringAzimuths, cosAzimuth, sinAzimuth);
+
   for (int i = 0; i <= numData - 1; i++) {
     // Convert to Psi
     float angle = ringAzimuths[i] * DEG2RAD - thetaT;
     angle = fixAngle(angle);
-    float xx = xCenter + radius * cos(angle + thetaT);
-    float yy = yCenter + radius * sin(angle + thetaT);
+    float xx = xCenter + radius * cosAzimuth[i];
+    float yy = yCenter + radius * sinAzimuth[i];
     float psiCorrection = atan2(yy, xx) - thetaT;
     ringPsi[i] = angle - psiCorrection;
     ringPsi[i] = fixAngle(ringPsi[i]);
@@ -72,50 +85,16 @@ bool GBVTD::analyzeRing(float& xCenter, float& yCenter, float& radius, float& he
     }
     vtdStdDev = -999;
     setWindCoefficients(radius, height, numCoeffs, FourierCoeffs, vtdCoeffs);
-    delete[] ringPsi;
-    delete[] vel;
-    delete[] psi;
     return false;
   }
 
   // Least squares
-  float** xLLS = new float*[numCoeffs];
-  for (int i = 0; i <= numCoeffs - 1; i++) {
-    xLLS[i] = new float[numData];
-  }
-  float* yLLS = new float[numData];
-  for (int i = 0; i <= numData - 1; i++) {
-    xLLS[0][i] = 1.;
-    for (int j = 1; j <= (numCoeffs / 2); j++) {
-      xLLS[2 * j - 1][i] = sin(float(j) * psi[i]);
-      xLLS[ 2 * j][i] = cos(float(j) * psi[i]);
-    }
-    yLLS[i] = vel[i];
-  }
-
-  float* stdError = new float[numCoeffs];
-  if( ! Matrix::lls(numCoeffs, numData, xLLS, yLLS, vtdStdDev, FourierCoeffs, stdError)) {
-    //Message::toScreen("GBVTD Returned Nothing from LLS");
-    for (int i = 0; i <= numCoeffs - 1; i++)
-      delete[] xLLS[i];
-    delete[] yLLS;
-    delete[] stdError;
-    delete[] ringPsi;
-    delete[] vel;
-    delete[] psi;
+  if ( ! fitFourier(numCoeffs, numData, vtdStdDev)) {
     return false;
   }
 
   // Convert Fourier coefficients into wind coefficients
   setWindCoefficients(radius, height, numCoeffs, FourierCoeffs, vtdCoeffs);
-  for (int i = 0; i <= numCoeffs - 1; i++)
-    delete[] xLLS[i];
-  delete[] xLLS;
-  delete[] yLLS;
-  delete[] stdError;
-  delete[] ringPsi;
-  delete[] vel;
-  delete[] psi;
   
   return true;
 }
@@ -123,19 +102,10 @@ bool GBVTD::analyzeRing(float& xCenter, float& yCenter, float& radius, float& he
 void GBVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs,
 				float*& FourierCoeffs, Coefficient*& vtdCoeffs)
 {
-  // Allocate and initialize the A & B coefficient arrays
+  // Initialize the A & B coefficient arrays
   
-  float* A;
-  float* B;
-  int maxIndex = numCoeffs / 2 + 1;
-    
-  if (maxIndex > 5) {
-    A = new float[numCoeffs / 2 + 1];
-    B = new float[numCoeffs / 2 + 1];
-  } else {
-    A = new float[5];
-    B = new float[5];
-  }
+  float* A = coeffA;
+  float* B = coeffB;
   for (int i=0; i <= 4; i++) {
     A[i] = 0;
     B[i] = 0;
@@ -153,13 +123,13 @@ void GBVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs,
   }
 
   // Use the specified closure method to set VT, VR, and VM
-  if (closure.contains(QString("original"), Qt::CaseInsensitive)) {
+  if (_originalClosure) {
 
     vtdCoeffs[0].setLevel(level);
     vtdCoeffs[0].setRadius(radius);
-    vtdCoeffs[0].setParameter("VTC0");
+    vtdCoeffs[0].setId(Coefficient::VTC0);
     float value;
-    if(closure.contains(QString("hvvp"), Qt::CaseInsensitive) and
+    if(_hvvpClosure and
        (B[1] != 0)) {
       value = - B[1] - B[3] - _hvvpMean * sinAlphamax;
     }
@@ -170,19 +140,19 @@ void GBVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs,
 
     vtdCoeffs[1].setLevel(level);
     vtdCoeffs[1].setRadius(radius);
-    vtdCoeffs[1].setParameter("VRC0");
+    vtdCoeffs[1].setId(Coefficient::VRC0);
     value = A[1] +A[3];
     vtdCoeffs[1].setValue(value);
 
     vtdCoeffs[2].setLevel(level);
     vtdCoeffs[2].setRadius(radius);
-    vtdCoeffs[2].setParameter("VMC0");
+    vtdCoeffs[2].setId(Coefficient::VMC0);
     value = A[0] + A[2]+ A[4];
     vtdCoeffs[2].setValue(value);
 
     vtdCoeffs[3].setLevel(level);
     vtdCoeffs[3].setRadius(radius);
-    vtdCoeffs[3].setParameter("VTS1");
+    vtdCoeffs[3].setId(Coefficient::VTS1);
 
     if ((sinAlphamax < 0.8) and (numCoeffs >= 5)) {
       value = A[2] - A[0] + A[4] + (A[0] + A[2] + A[4]) * cosAlphamax;
@@ -197,7 +167,7 @@ void GBVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs,
 
     vtdCoeffs[4].setLevel(level);
     vtdCoeffs[4].setRadius(radius);
-    vtdCoeffs[4].setParameter("VTC1");
+    vtdCoeffs[4].setId(Coefficient::VTC1);
 	
     if ((sinAlphamax < 0.8) and (numCoeffs >= 5)) {
       value = -2. * (B[2] + B[4]);
@@ -213,20 +183,15 @@ void GBVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs,
     for (int i=5; i <= numCoeffs - 1; i += 2) {
       vtdCoeffs[i].setLevel(level);
       vtdCoeffs[i].setRadius(radius);
-      QString param = "VTC" + QString().setNum(int(i / 2));
-      vtdCoeffs[i].setParameter(param);
+      vtdCoeffs[i].setId(Coefficient::vtc(i / 2));
       value = -2. * B[i / 2 + 1];
       vtdCoeffs[i].setValue(value);
 
       vtdCoeffs[i+1].setLevel(level);
       vtdCoeffs[i+1].setRadius(radius);
-      param = "VTS" + QString().setNum(int(i / 2));
-      vtdCoeffs[i + 1].setParameter(param);
+      vtdCoeffs[i + 1].setId(Coefficient::vts(i / 2));
       value = 2 * A[i / 2 + 1];
       vtdCoeffs[i + 1].setValue(value);
     }
   } 
-
-  delete[] A;
-  delete[] B;
 }
@@ -25,6 +25,8 @@ public:
     GBVTD(QString& initClosure, int& wavenumbers, float*& gaps, float hvvpwind);
     virtual ~GBVTD();
 
+    VTD* clone() const;
+
     bool analyzeRing(float& xCenter, float& yCenter, float& radius,
 		     float& height, int& numData, float*& ringData,
 		     float*& ringAzimuths, Coefficient*& vtdCoeffs,
@@ -25,30 +25,41 @@ GVTD::~GVTD()
 {
 }
 
+VTD* GVTD::clone() const
+{
+  QString cloneClosure = closure;
+  int waveNumbers = _maxWaveNum;
+  float* gaps = dataGaps;
+  GVTD* copy = new GVTD(cloneClosure, waveNumbers, gaps, _hvvpMean);
+  copy->setFixedAzimuths(_fixedAzimuths);
+  return copy;
+}
+
 bool GVTD::analyzeRing(float& xCenter, float& yCenter, float& radius, float& height, int& numData, 
                         float*& ringData, float*& ringAzimuths, Coefficient*& vtdCoeffs, float& vtdStdDev)
 {
   // Implement GVTD by Ting-Yu Cha, 11/03/2017
   // Analye a ring of data
 
-  // Make a Psi array
-  
-  ringPsi = new float[numData];
-  vel = new float[numData];
-  psi = new float[numData];
-  float *ringDistance = new float[numData];
+  // Make sure the workspace can hold the ring, no-op once it's big enough
+  reserveWorkspace(numData);
 
   // Get thetaT
   thetaT = atan2(yCenter,xCenter);
   thetaT = fixAngle(thetaT);
   centerDistance = sqrt(xCenter * xCenter + yCenter * yCenter);
 
+  // The cos and sin of angle + thetaT, which is just the azimuth
+  const float* cosAzimuth;
+  const float* sinAzimuth;
+  ringTrig(numData, ringAzimuths, cosAzimuth, sinAzimuth);
+
   for (int i = 0; i < numData; i++) {
     // Convert to Psi
     float angle = ringAzimuths[i] * DEG2RAD - thetaT;
     angle = fixAngle(angle);
-    float xx = xCenter + radius * cos(angle + thetaT);
-    float yy = yCenter + radius * sin(angle + thetaT);
+    float xx = xCenter + radius * cosAzimuth[i];
+    float yy = yCenter + radius * sinAzimuth[i];
     ringDistance[i] = sqrt(xx * xx + yy * yy);
     ringPsi[i] = angle;
   }
@@ -76,53 +87,17 @@ bool GVTD::analyzeRing(float& xCenter, float& yCenter, float& radius, float& hei
     }
     vtdStdDev = -999;
     setWindCoefficients(radius, height, numCoeffs, FourierCoeffs, vtdCoeffs);
-    delete[] ringPsi;
-    delete[] vel;
-    delete[] psi;
-    delete[] ringDistance;
     return false;
   }
 
   // Least squares
   
-  float** xLLS = new float*[numCoeffs];
-  for (int i = 0; i <= numCoeffs - 1; i++) {
-    xLLS[i] = new float[numData];
-  }
-  float* yLLS = new float[numData];
-  for (int i = 0; i <= numData - 1; i++) {
-    xLLS[0][i] = 1.;
-    for (int j = 1; j <= (numCoeffs / 2); j++) {
-      xLLS[2 * j - 1][i] = sin(float(j) * psi[i]);
-      xLLS[ 2 * j][i] = cos(float(j) * psi[i]);
-    }
-    yLLS[i] = vel[i];
-  }
-
-  float* stdError = new float[numCoeffs];
-  if( ! Matrix::lls(numCoeffs, numData, xLLS, yLLS, vtdStdDev, FourierCoeffs, stdError)) {
-    for (int i = 0; i <= numCoeffs - 1; i++)
-      delete[] xLLS[i];
-    delete[] yLLS;
-    delete[] stdError;
-    delete[] ringPsi;
-    delete[] vel;
-    delete[] psi;
+  if ( ! fitFourier(numCoeffs, numData, vtdStdDev)) {
     return false;
   }
 
   // Convert Fourier coefficients into wind coefficients
   setWindCoefficients(radius, height, numCoeffs, FourierCoeffs, vtdCoeffs);
-  
-  for (int i = 0; i <= numCoeffs - 1; i++)
-    delete[] xLLS[i];
-  
-  delete[] xLLS;
-  delete[] yLLS;
-  delete[] stdError;
-  delete[] ringPsi;
-  delete[] vel;
-  delete[] psi;
 
   return true;
 }
@@ -130,19 +105,10 @@ bool GVTD::analyzeRing(float& xCenter, float& yCenter, float& radius, float& hei
 void GVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs, float*& FourierCoeffs,
 				Coefficient*& vtdCoeffs)
 {
-    // Allocate and initialize the A & B coefficient arrays
+    // Initialize the A & B coefficient arrays
   
-    float* A;
-    float* B;
-    int maxIndex = numCoeffs / 2 + 1;
-    
-    if (maxIndex > 5) {
-        A = new float[numCoeffs / 2 + 1];
-        B = new float[numCoeffs / 2 + 1];
-    } else {
-        A = new float[5];
-        B = new float[5];
-    }
+    float* A = coeffA;
+    float* B = coeffB;
     for (int i=0; i <= 4; i++) {
         A[i] = 0;
         B[i] = 0;
@@ -184,19 +150,19 @@ void GVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs, floa
     }
     
     // Use the specified closure method to set VT, VR, and VM
-    if (closure.contains(QString("original"), Qt::CaseInsensitive)) {
+    if (_originalClosure) {
 
       // Implement GVTD by Ting-Yu Cha 11/03/2017
       vtdCoeffs[0].setLevel(level);
       vtdCoeffs[0].setRadius(radius);
-      vtdCoeffs[0].setParameter("VTC0");
+      vtdCoeffs[0].setId(Coefficient::VTC0);
       float value;
       value = - B[1] - B[3];
       vtdCoeffs[0].setValue(value);
 
       vtdCoeffs[1].setLevel(level);
       vtdCoeffs[1].setRadius(radius);
-      vtdCoeffs[1].setParameter("VRC0");
+      vtdCoeffs[1].setId(Coefficient::VRC0);
       value = (A[0] + A[1] + A[2] + A[3] + A[4]) / ( 1 + radius / centerDistance);
       vtdCoeffs[1].setValue(value);
 
@@ -206,27 +172,22 @@ void GVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs, floa
       for (int i=3; i <= numCoeffs - 1; i += 2) {
 	vtdCoeffs[i].setLevel(level);
 	vtdCoeffs[i].setRadius(radius);
-	QString param = "VTC" + QString().setNum(int(i / 2));
-	vtdCoeffs[i].setParameter(param);
+	vtdCoeffs[i].setId(Coefficient::vtc(i / 2));
 	value = -2. * B[i / 2 + 1];
 	vtdCoeffs[i].setValue(value);
 
 	vtdCoeffs[i+1].setLevel(level);
 	vtdCoeffs[i+1].setRadius(radius);
-	param = "VTS" + QString().setNum(int(i / 2));
-	vtdCoeffs[i + 1].setParameter(param);
+	vtdCoeffs[i + 1].setId(Coefficient::vts(i / 2));
 	value = 2 * A[i / 2 + 1];
 	vtdCoeffs[i + 1].setValue(value);
       }
       
       vtdCoeffs[2].setLevel(level);
       vtdCoeffs[2].setRadius(radius);
-      vtdCoeffs[2].setParameter("VMC0");
+      vtdCoeffs[2].setId(Coefficient::VMC0);
       value = A[0] - ( radius / centerDistance * vtdCoeffs[1].getValue() ) + 0.5 * vtdCoeffs[4].getValue();
       // rhs value is VRC0 value computed just above
       vtdCoeffs[2].setValue(value);
     }
-
-    delete[] A;
-    delete[] B;
 }
@@ -21,6 +21,8 @@ public:
     
     ~GVTD();
 
+    VTD* clone() const;
+
     bool analyzeRing(float& xCenter, float& yCenter, float& radius,
 		     float& height, int& numData, float*& ringData,
 		     float*& ringAzimuths, Coefficient*& vtdCoeffs,
@@ -13,8 +13,9 @@
 #include "GVTD.h"
 
 #include <math.h>
+#include <algorithm>
 #include "IO/Message.h"
-#include "Math/Matrix.h"
+#include "Math/Cholesky.h"
 
 const float VTD::PI      = 3.1415926f;
 const float VTD::DEG2RAD = PI/180.f;
@@ -23,16 +24,181 @@ const float VTD::RAD2DEG = 180.f/PI;
 VTD::VTD(QString& initClosure, int& wavenumbers, float*& gaps, float hvvpwind)
 {
     closure = initClosure;
+    _originalClosure = closure.contains(QString("original"), Qt::CaseInsensitive);
+    _hvvpClosure = closure.contains(QString("hvvp"), Qt::CaseInsensitive);
+    _fixedAzimuths = false;
     _maxWaveNum = wavenumbers;
+    _maxCoeffs = _maxWaveNum * 2 + 3;
     dataGaps = gaps;
-    FourierCoeffs = new float[_maxWaveNum * 2 + 3];
+    FourierCoeffs = new float[_maxCoeffs];
     _hvvpMean = hvvpwind;
+
+    // Everything but the data sized arrays can be allocated up front
+
+    basis = new double[_maxCoeffs];
+    normalSum = new double[_maxCoeffs * _maxCoeffs];
+    rhsSum = new double[_maxCoeffs];
+    solution = new double[_maxCoeffs];
+
+    // A & B hold wavenumbers 0 through numCoeffs/2, but the closures
+    // always look at the first 5
+    int numAB = (_maxCoeffs / 2 + 1 > 5) ? _maxCoeffs / 2 + 1 : 5;
+    coeffA = new float[numAB];
+    coeffB = new float[numAB];
+
+    _workspaceSize = 0;
+    ringPsi = NULL;
+    vel = NULL;
+    psi = NULL;
+    ringDistance = NULL;
+    ringCos = NULL;
+    ringSin = NULL;
+    sharedCos = NULL;
+    sharedSin = NULL;
+    _useSharedTrig = false;
 }
 
 VTD::~VTD()
 {
     // Default destructor
     delete[] FourierCoeffs;
+    delete[] basis;
+    delete[] normalSum;
+    delete[] rhsSum;
+    delete[] solution;
+    delete[] coeffA;
+    delete[] coeffB;
+
+    delete[] ringPsi;
+    delete[] vel;
+    delete[] psi;
+    delete[] ringDistance;
+    delete[] ringCos;
+    delete[] ringSin;
+    delete[] sharedCos;
+    delete[] sharedSin;
+}
+
+void VTD::reserveWorkspace(int maxData)
+{
+    if (maxData <= _workspaceSize)
+        return;
+
+    // Leave some headroom so slowly growing rings don't reallocate every time
+    int size = maxData + maxData / 4;
+
+    delete[] ringPsi;
+    delete[] vel;
+    delete[] psi;
+    delete[] ringDistance;
+    delete[] ringCos;
+    delete[] ringSin;
+    delete[] sharedCos;
+    delete[] sharedSin;
+
+    ringPsi = new float[size];
+    vel = new float[size];
+    psi = new float[size];
+    ringDistance = new float[size];
+    ringCos = new float[size];
+    ringSin = new float[size];
+    sharedCos = new float[size];
+    sharedSin = new float[size];
+
+    _workspaceSize = size;
+}
+
+int VTD::analyzeRings(float& xCenter, float& yCenter, float& height,
+                      const int& numRings, const float* radii,
+                      const int* ringOffset, const int* ringLength,
+                      float* ringData, float* ringAzimuths,
+                      Coefficient* vtdCoeffs, const int& coeffStride,
+                      float* stdDev, bool* valid)
+{
+    return analyzeBatch(numRings, &xCenter, &yCenter, 0, radii, 1, height,
+                        ringOffset, ringLength, ringData, ringAzimuths,
+                        vtdCoeffs, coeffStride, stdDev, valid, false);
+}
+
+int VTD::analyzeCenters(const int& numCenters, const float* xCenters,
+                        const float* yCenters, float& radius, float& height,
+                        const int* ringOffset, const int* ringLength,
+                        float* ringData, float* ringAzimuths,
+                        Coefficient* vtdCoeffs, const int& coeffStride,
+                        float* stdDev, bool* valid)
+{
+    return analyzeBatch(numCenters, xCenters, yCenters, 1, &radius, 0, height,
+                        ringOffset, ringLength, ringData, ringAzimuths,
+                        vtdCoeffs, coeffStride, stdDev, valid, true);
+}
+
+int VTD::analyzeBatch(const int& numRings, const float* xCenters,
+                      const float* yCenters, const int& centerStep,
+                      const float* radii, const int& radiusStep,
+                      const float& height, const int* ringOffset,
+                      const int* ringLength, float* ringData,
+                      float* ringAzimuths, Coefficient* vtdCoeffs,
+                      const int& coeffStride, float* stdDev, bool* valid,
+                      bool shareTrig)
+{
+    // Size the workspace for the biggest ring up front, then every ring
+    // reuses it
+    int maxLength = 0;
+    int longest = 0;
+    for (int n = 0; n < numRings; n++) {
+        if (ringLength[n] > maxLength) {
+            maxLength = ringLength[n];
+            longest = n;
+        }
+    }
+    reserveWorkspace(maxLength);
+
+    // Rings about shifted centers have the same azimuths unless some of
+    // their cells were off the grid. The longest ring has them all.
+    const float* sharedAzimuths = NULL;
+    if (shareTrig && (maxLength > 0)) {
+        sharedAzimuths = ringAzimuths + ringOffset[longest];
+        for (int i = 0; i < maxLength; i++) {
+            sharedCos[i] = cos(sharedAzimuths[i] * DEG2RAD);
+            sharedSin[i] = sin(sharedAzimuths[i] * DEG2RAD);
+        }
+    }
+
+    int numGood = 0;
+    for (int n = 0; n < numRings; n++) {
+        float xCenter = xCenters[n * centerStep];
+        float yCenter = yCenters[n * centerStep];
+        float radius = radii[n * radiusStep];
+        float ringHeight = height;
+        int numData = ringLength[n];
+        float* data = ringData + ringOffset[n];
+        float* azimuths = ringAzimuths + ringOffset[n];
+        Coefficient* coeffs = vtdCoeffs + n * coeffStride;
+        _useSharedTrig = (sharedAzimuths != NULL) && (numData == maxLength)
+            && std::equal(azimuths, azimuths + numData, sharedAzimuths);
+        valid[n] = analyzeRing(xCenter, yCenter, radius, ringHeight, numData,
+                               data, azimuths, coeffs, stdDev[n]);
+        if (valid[n])
+            numGood++;
+    }
+    _useSharedTrig = false;
+    return numGood;
+}
+
+void VTD::ringTrig(const int& numData, const float* ringAzimuths,
+                   const float*& cosAzimuth, const float*& sinAzimuth)
+{
+    if (_useSharedTrig) {
+        cosAzimuth = sharedCos;
+        sinAzimuth = sharedSin;
+        return;
+    }
+    for (int i = 0; i < numData; i++) {
+        ringCos[i] = cos(ringAzimuths[i] * DEG2RAD);
+        ringSin[i] = sin(ringAzimuths[i] * DEG2RAD);
+    }
+    cosAzimuth = ringCos;
+    sinAzimuth = ringSin;
 }
 
 int VTD::getNumCoefficients(int& numData)
@@ -81,6 +247,243 @@ int VTD::getNumCoefficients(int& numData)
     return 0;
 }
 
+bool VTD::fitFourier(const int& numCoeffs, const int& numData, float& stdDev)
+{
+    // Accumulate the normal equations in a single pass over the ring
+    // instead of building the numCoeffs x numData design matrix. The
+    // higher harmonics come from the Chebyshev recurrences
+    //   sin((k+1)psi) = 2cos(psi)sin(k psi) - sin((k-1)psi)
+    //   cos((k+1)psi) = 2cos(psi)cos(k psi) - cos((k-1)psi)
+    // so each point needs only one sin and one cos.
+
+    if (numData < numCoeffs)
+        return false;
+
+    if (_fixedAzimuths && isUniformRing(numCoeffs, numData))
+        return fitUniform(numCoeffs, numData, stdDev);
+
+    switch (numCoeffs) {
+    case 3:  return fitFourierFixed<0>(numData, stdDev);
+    case 5:  return fitFourierFixed<1>(numData, stdDev);
+    case 7:  return fitFourierFixed<2>(numData, stdDev);
+    case 9:  return fitFourierFixed<3>(numData, stdDev);
+    case 11: return fitFourierFixed<4>(numData, stdDev);
+    default: break;
+    }
+
+    int n = numCoeffs;
+    int maxWave = numCoeffs / 2;
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++)
+            normalSum[row * n + col] = 0.;
+        rhsSum[row] = 0.;
+    }
+    double sumSquares = 0.;
+
+    for (int i = 0; i < numData; i++) {
+        double s1 = sin(psi[i]);
+        double c1 = cos(psi[i]);
+        double twoC1 = 2. * c1;
+        double sPrev = 0., cPrev = 1.;
+        double s = s1, c = c1;
+        basis[0] = 1.;
+        for (int j = 1; j <= maxWave; j++) {
+            basis[2 * j - 1] = s;
+            basis[2 * j] = c;
+            double sNext = twoC1 * s - sPrev;
+            double cNext = twoC1 * c - cPrev;
+            sPrev = s;
+            cPrev = c;
+            s = sNext;
+            c = cNext;
+        }
+
+        double y = vel[i];
+        sumSquares += y * y;
+        for (int row = 0; row < n; row++) {
+            double b = basis[row];
+            double* sumRow = normalSum + row * n;
+            for (int col = row; col < n; col++)
+                sumRow[col] += b * basis[col];
+            rhsSum[row] += b * y;
+        }
+    }
+
+    // Fill in the lower half and solve
+    for (int row = 1; row < n; row++)
+        for (int col = 0; col < row; col++)
+            normalSum[row * n + col] = normalSum[col * n + row];
+
+    if (!Cholesky::solve(n, normalSum, rhsSum, solution))
+        return false;
+
+    for (int i = 0; i < n; i++)
+        FourierCoeffs[i] = solution[i];
+
+    // Residual sum of squares from the accumulated sums,
+    // |y - Xa|^2 = y'y - 2a'X'y + a'X'Xa
+    double residual = sumSquares;
+    for (int row = 0; row < n; row++) {
+        double a = solution[row];
+        double fit = 0.;
+        for (int col = 0; col < n; col++)
+            fit += normalSum[row * n + col] * solution[col];
+        residual += a * (fit - 2. * rhsSum[row]);
+    }
+    if (residual < 0.)
+        residual = 0.;
+
+    if (numData != numCoeffs)
+        stdDev = sqrt(residual / double(numData - numCoeffs));
+    else
+        stdDev = sqrt(residual);
+
+    return true;
+}
+
+bool VTD::isUniformRing(const int& numCoeffs, const int& numData)
+{
+    // Every point has to be there and consecutive psi's have to step
+    // by 2Pi/numData, including the step from the last back to the first.
+    // Wavenumber numCoeffs/2 needs more than 2 points per wavelength.
+
+    if (numData < numCoeffs)
+        return false;
+    double step = 2. * PI / numData;
+    double tolerance = 1.e-3 * step;
+    for (int i = 0; i < numData; i++) {
+        double delta = psi[(i + 1) % numData] - psi[i];
+        if (delta < 0.)
+            delta += 2. * PI;
+        if (fabs(delta - step) > tolerance)
+            return false;
+    }
+    return true;
+}
+
+bool VTD::fitUniform(const int& numCoeffs, const int& numData, float& stdDev)
+{
+    // Direct DFT of the first numCoeffs/2 harmonics, using the same
+    // recurrences as fitFourier. For the few harmonics used here this is
+    // cheaper than a full FFT of the ring.
+
+    int maxWave = numCoeffs / 2;
+    for (int i = 0; i < numCoeffs; i++)
+        solution[i] = 0.;
+    double sumSquares = 0.;
+
+    for (int i = 0; i < numData; i++) {
+        double y = vel[i];
+        double c1 = cos(psi[i]);
+        double twoC1 = 2. * c1;
+        double sPrev = 0., cPrev = 1.;
+        double s = sin(psi[i]), c = c1;
+        solution[0] += y;
+        sumSquares += y * y;
+        for (int j = 1; j <= maxWave; j++) {
+            solution[2 * j - 1] += y * s;
+            solution[2 * j] += y * c;
+            double sNext = twoC1 * s - sPrev;
+            double cNext = twoC1 * c - cPrev;
+            sPrev = s;
+            cPrev = c;
+            s = sNext;
+            c = cNext;
+        }
+    }
+
+    // Normalize, and get the residual from Parseval
+    double residual = sumSquares;
+    solution[0] /= numData;
+    residual -= numData * solution[0] * solution[0];
+    for (int i = 1; i < numCoeffs; i++) {
+        solution[i] *= 2. / numData;
+        residual -= 0.5 * numData * solution[i] * solution[i];
+    }
+    if (residual < 0.)
+        residual = 0.;
+
+    for (int i = 0; i < numCoeffs; i++)
+        FourierCoeffs[i] = solution[i];
+
+    if (numData != numCoeffs)
+        stdDev = sqrt(residual / double(numData - numCoeffs));
+    else
+        stdDev = sqrt(residual);
+
+    return true;
+}
+
+template<int W>
+bool VTD::fitFourierFixed(const int& numData, float& stdDev)
+{
+    // Same as the general path in fitFourier, with the sizes known
+    const int N = 2 * W + 3;
+    const int H = W + 1;
+
+    double normal[N][N];
+    double rhs[N];
+    for (int row = 0; row < N; row++) {
+        for (int col = 0; col < N; col++)
+            normal[row][col] = 0.;
+        rhs[row] = 0.;
+    }
+    double sumSquares = 0.;
+
+    for (int i = 0; i < numData; i++) {
+        double b[N];
+        double c1 = cos(psi[i]);
+        double twoC1 = 2. * c1;
+        double sPrev = 0., cPrev = 1.;
+        double s = sin(psi[i]), c = c1;
+        b[0] = 1.;
+        for (int j = 1; j <= H; j++) {
+            b[2 * j - 1] = s;
+            b[2 * j] = c;
+            double sNext = twoC1 * s - sPrev;
+            double cNext = twoC1 * c - cPrev;
+            sPrev = s;
+            cPrev = c;
+            s = sNext;
+            c = cNext;
+        }
+
+        double y = vel[i];
+        sumSquares += y * y;
+        for (int row = 0; row < N; row++) {
+            for (int col = row; col < N; col++)
+                normal[row][col] += b[row] * b[col];
+            rhs[row] += b[row] * y;
+        }
+    }
+
+    for (int row = 1; row < N; row++)
+        for (int col = 0; col < row; col++)
+            normal[row][col] = normal[col][row];
+
+    double coeff[N];
+    if (!Cholesky::solve<N>(&normal[0][0], rhs, coeff))
+        return false;
+
+    double residual = sumSquares;
+    for (int row = 0; row < N; row++) {
+        double fit = 0.;
+        for (int col = 0; col < N; col++)
+            fit += normal[row][col] * coeff[col];
+        residual += coeff[row] * (fit - 2. * rhs[row]);
+        FourierCoeffs[row] = coeff[row];
+    }
+    if (residual < 0.)
+        residual = 0.;
+
+    if (numData != N)
+        stdDev = sqrt(residual / double(numData - N));
+    else
+        stdDev = sqrt(residual);
+
+    return true;
+}
+
 float VTD::fixAngle(float& angle)
 {
     // Make sure an angle is between 0 and 2Pi
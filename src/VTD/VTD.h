@@ -23,6 +23,10 @@ class VTD
     
   virtual ~VTD();
 
+  // A new VTD of the same kind and settings with its own workspace, so
+  // rings can be fitted on several threads at once
+  virtual VTD* clone() const = 0;
+
   // Analyze one ring of data
     
   virtual bool analyzeRing(float& xCenter, float& yCenter, float& radius,
@@ -30,16 +34,74 @@ class VTD
 			   float*& ringAzimuths, Coefficient*& vtdCoeffs,
 			   float& stdDev) = 0;
 
+  // Analyze all the rings of one level about the same center. Ring n has
+  // ringLength[n] points at ringOffset[n] in ringData/ringAzimuths, its
+  // coefficients go to vtdCoeffs[n*coeffStride], and its fit error and
+  // success to stdDev[n] and valid[n]. Returns the number of good rings.
+
+  int analyzeRings(float& xCenter, float& yCenter, float& height,
+		   const int& numRings, const float* radii,
+		   const int* ringOffset, const int* ringLength,
+		   float* ringData, float* ringAzimuths,
+		   Coefficient* vtdCoeffs, const int& coeffStride,
+		   float* stdDev, bool* valid);
+
+  // The same ring about each of numCenters candidate centers, as laid
+  // out by GriddedData::getCylindricalRingsData. Arguments as for
+  // analyzeRings, with one center per ring instead of one radius. The
+  // rings have the same cells apart from those off the grid, so the
+  // cos/sin of their azimuths are worked out once for all of them.
+
+  int analyzeCenters(const int& numCenters, const float* xCenters,
+		     const float* yCenters, float& radius, float& height,
+		     const int* ringOffset, const int* ringLength,
+		     float* ringData, float* ringAzimuths,
+		     Coefficient* vtdCoeffs, const int& coeffStride,
+		     float* stdDev, bool* valid);
+
   virtual void  setWindCoefficients(float& radius, float& height,
 				    int& numCoefficients, float*& FourierCoeffs,
 				    Coefficient*& vtdCoeffs) = 0;
     
   void setHVVP(const float& meanWind);
 
+  // The rings are sampled at fixed azimuths, as from GriddedData::
+  // getCylindricalAzimuthSamples. Only such rings can be evenly spaced,
+  // so only they are checked for the direct DFT in fitFourier.
+  void setFixedAzimuths(bool fixed) { _fixedAzimuths = fixed; }
+
+  // Size the ring scratch space for rings of up to maxData points.
+  // analyzeRing grows it on demand, so this is only needed to keep
+  // the first few rings from allocating.
+  void reserveWorkspace(int maxData);
+
   int   getNumCoefficients(int& numData);
   float fixAngle(float& angle);
 
  protected:
+
+  // Least squares fit of the harmonics 1, sin(psi), cos(psi), ... to the
+  // first numData points of psi/vel, into FourierCoeffs
+  bool fitFourier(const int& numCoeffs, const int& numData, float& stdDev);
+
+  // fitFourier for a fixed number of coefficients, 2*W + 3. Production
+  // runs use W of 0 through 4, fitFourier dispatches those here so the
+  // harmonic loops unroll and the normal equations stay on the stack.
+  template<int W>
+  bool fitFourierFixed(const int& numData, float& stdDev);
+
+  // When the ring is complete and evenly spaced in psi the harmonics are
+  // orthogonal, and the least squares fit is just the low order terms of
+  // the discrete Fourier transform. fitFourier checks for this first
+  // when the rings come at fixed azimuths.
+  bool isUniformRing(const int& numCoeffs, const int& numData);
+  bool fitUniform(const int& numCoeffs, const int& numData, float& stdDev);
+
+  // cos and sin of each of the ring's azimuths, for the psi mapping of
+  // analyzeRing. They come from the table analyzeCenters shares between
+  // identical rings, or are worked out into ringCos/ringSin.
+  void ringTrig(const int& numData, const float* ringAzimuths,
+                const float*& cosAzimuth, const float*& sinAzimuth);
     
   static const float PI     ;
   static const float DEG2RAD;
@@ -47,7 +109,11 @@ class VTD
 
   QString geometry;
   QString closure;
+  bool _originalClosure;
+  bool _hvvpClosure;
+  bool _fixedAzimuths;
   int _maxWaveNum;
+  int _maxCoeffs;
   float* dataGaps;
 
   float* ringPsi;
@@ -60,6 +126,42 @@ class VTD
 
   float _hvvpMean;
 
+  // Scratch space reused by every analyzeRing call. The data sized
+  // arrays hold _workspaceSize points, the rest are sized by _maxCoeffs.
+
+  int _workspaceSize;
+  float* ringDistance;
+  float* ringCos;
+  float* ringSin;
+  float* sharedCos;
+  float* sharedSin;
+  bool _useSharedTrig;
+  double* basis;
+  double* normalSum;
+  double* rhsSum;
+  double* solution;
+  float* coeffA;
+  float* coeffB;
+
+ private:
+
+  // analyzeRings and analyzeCenters: ring n is about
+  // (xCenters[n*centerStep], yCenters[n*centerStep]) with radius
+  // radii[n*radiusStep]. shareTrig makes the cos/sin table of the longest
+  // ring and uses it for every ring with the same azimuths.
+  int analyzeBatch(const int& numRings, const float* xCenters,
+                   const float* yCenters, const int& centerStep,
+                   const float* radii, const int& radiusStep,
+                   const float& height, const int* ringOffset,
+                   const int* ringLength, float* ringData,
+                   float* ringAzimuths, Coefficient* vtdCoeffs,
+                   const int& coeffStride, float* stdDev, bool* valid,
+                   bool shareTrig);
+
+  // The workspace is owned, so no copies
+  VTD(const VTD&);
+  VTD& operator=(const VTD&);
+
 };
 
 #endif
@@ -30,25 +30,30 @@ float MGBVTD::computeCrossBeamWind(float guessMax, QString& velField, GBVTD* gbv
 	std::vector<float> vt;
 	std::vector<float> vt_rng;
 	//1. compute the radial profile of symmetric tangential wind  
+	// The ring buffers only ever grow, so they are reused from ring to ring
+	std::vector<float> ringBuf;
+	std::vector<float> aziBuf;
+	Coefficient* coeff = new Coefficient[20];
+	m_cappi.setCartesianReferencePoint(m_centerx, m_centery, m_centerz);
 	for(float rng=m_rmw*1.2; rng<=.6*Rt; rng+=1.){
-		m_cappi.setCartesianReferencePoint(m_centerx, m_centery, m_centerz);
 		int numData = m_cappi.getCylindricalAzimuthLength(rng, m_centerz);
-		float* ringData = new float[numData];
-		float* ringAzi  = new float[numData];
+		if(numData > (int)ringBuf.size()){
+			ringBuf.resize(numData);
+			aziBuf.resize(numData);
+		}
+		float* ringData = ringBuf.data();
+		float* ringAzi  = aziBuf.data();
 		m_cappi.getCylindricalAzimuthData(velField, numData, rng, m_centerz, ringData);
         m_cappi.getCylindricalAzimuthPosition(numData, rng, m_centerz, ringAzi);
-		Coefficient* coeff = new Coefficient[20];
 		float vtdDev;
 		if(gbvtd->analyzeRing(m_centerx, m_centery, rng, m_centerz, numData, ringData, ringAzi, coeff, vtdDev)){
-			if(coeff[0].getParameter()=="VTC0"){
+			if(coeff[0].getId()==Coefficient::VTC0){
 				vt.push_back(coeff[0].getValue());
 				vt_rng.push_back(rng);
 			}
 		}
-		delete[] ringAzi;
-		delete[] ringData;
-		delete[] coeff;
 	}
+	delete[] coeff;
 	if(vt.size()<15) {
 		// std::cout<<std::endl;
 		return 0.f;
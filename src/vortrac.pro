@@ -58,12 +58,15 @@ QMAKE_CXXFLAGS += -std=c++0x
 HEADERS += Threads/workThread.h \
            Threads/SimplexThread.h \
            Threads/VortexThread.h \
+           Threads/ParallelFor.h \
            DataObjects/VortexData.h \
            DataObjects/SimplexData.h \
            DataObjects/VortexList.h \
            DataObjects/SimplexList.h \
            DataObjects/Coefficient.h \
            DataObjects/Center.h \
+           DataObjects/RingCache.h \
+           DataObjects/VortexTracker.h \
            Config/Configuration.h \
            DataObjects/AnalyticGrid.h \
            DataObjects/CappiGrid.h \
@@ -106,6 +109,7 @@ HEADERS += Threads/workThread.h \
            VTD/mgbvtd.h \
            VTD/VTDFactory.h \
            Math/Matrix.h \
+           Math/Cholesky.h \
            ChooseCenter.h \
            Pressure/PressureData.h \
            Pressure/PressureList.h \
@@ -129,6 +133,8 @@ SOURCES += main.cpp \
            DataObjects/SimplexList.cpp \
            DataObjects/Coefficient.cpp \
            DataObjects/Center.cpp \
+           DataObjects/RingCache.cpp \
+           DataObjects/VortexTracker.cpp \
            Config/Configuration.cpp \
            DataObjects/AnalyticGrid.cpp \
            DataObjects/CappiGrid.cpp \
@@ -170,6 +176,7 @@ SOURCES += main.cpp \
            VTD/mgbvtd.cpp \
            VTD/VTDFactory.cpp \
            Math/Matrix.cpp \
+           Math/Cholesky.cpp \
            ChooseCenter.cpp \
            Pressure/PressureData.cpp \
            Pressure/PressureList.cpp \
@@ -187,5 +194,6 @@ RESOURCES += vortrac.qrc
 LIBS += -lRadx -lNcxx -lnetcdf -lhdf5_cpp -lhdf5 -larmadillo -lz -lbz2
 QT += xml network widgets
 
+# DEFINES += VORTRAC_ARMADILLO_MATRIX
 # CONFIG += debug
 #CONFIG -= app_bundle
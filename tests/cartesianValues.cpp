@@ -0,0 +1,127 @@
+/*
+ *  cartesianValues.cpp
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+// Checks GriddedData::getCartesianValues on a linear field, which
+// trilinear interpolation reproduces exactly, and checks that points off
+// the grid or next to missing data come back as -999. Returns non zero
+// on the first wrong value.
+
+#include <math.h>
+#include <iostream>
+#include <random>
+#include "DataObjects/GriddedData.h"
+
+static float linear(float x, float y, float z)
+{
+    return 5 + 0.5*x - 0.25*y + 2*z;
+}
+
+class LinearGrid : public GriddedData
+{
+public:
+    void fill()
+    {
+        iDim = 30; jDim = 20; kDim = 8;
+        iGridsp = 1.0; jGridsp = 2.0; kGridsp = 0.5;
+        xmin = -10; ymin = 4; zmin = 1;
+        xmax = xmin + (iDim - 1)*iGridsp;
+        ymax = ymin + (jDim - 1)*jGridsp;
+        zmax = zmin + (kDim - 1)*kGridsp;
+        for(int i = 0; i < iDim; i++)
+            for(int j = 0; j < jDim; j++)
+                for(int k = 0; k < kDim; k++)
+                    dataGrid[0][i][j][k] = linear(xmin + i*iGridsp, ymin + j*jGridsp,
+                                                  zmin + k*kGridsp);
+    }
+
+    // Marks one cell missing, with its cartesian position
+    void setMissing(int i, int j, int k, float& x, float& y, float& z)
+    {
+        dataGrid[0][i][j][k] = -999.;
+        x = xmin + i*iGridsp;
+        y = ymin + j*jGridsp;
+        z = zmin + k*kGridsp;
+    }
+};
+
+static bool report(const char* what, int n, float value, float expected)
+{
+    std::cerr << what << " point " << n << ": " << value << ", expected "
+              << expected << std::endl;
+    return false;
+}
+
+int main()
+{
+    LinearGrid* grid = new LinearGrid;
+    grid->fill();
+    int field = grid->getFieldIndex(QString("DZ"));
+
+    // Random points inside the grid, including its faces
+    std::mt19937 random(20260101);
+    std::uniform_real_distribution<float> xs(-10., 19.);
+    std::uniform_real_distribution<float> ys(4., 42.);
+    std::uniform_real_distribution<float> zs(1., 4.5);
+    const int numPoints = 2000;
+    float x[numPoints], y[numPoints], z[numPoints], values[numPoints];
+    for(int n = 0; n < numPoints; n++) {
+        x[n] = xs(random);
+        y[n] = ys(random);
+        z[n] = zs(random);
+    }
+    x[0] = -10; y[0] = 4; z[0] = 1;
+    x[1] = 19; y[1] = 42; z[1] = 4.5;
+
+    bool ok = true;
+    grid->getCartesianValues(field, numPoints, x, y, z, values);
+    for(int n = 0; ok && (n < numPoints); n++) {
+        float expected = linear(x[n], y[n], z[n]);
+        if(fabs(values[n] - expected) > 1.e-3*(1 + fabs(expected)))
+            ok = report("inside", n, values[n], expected);
+    }
+
+    // The field name overload resolves to the same field
+    float named[numPoints];
+    grid->getCartesianValues(QString("DZ"), numPoints, x, y, z, named);
+    for(int n = 0; ok && (n < numPoints); n++) {
+        if(named[n] != values[n])
+            ok = report("by name", n, named[n], values[n]);
+    }
+
+    // Off every face of the grid
+    float xOut[] = { -10.5, 19.5, 0, 0, 0, 0 };
+    float yOut[] = { 10, 10, 3.5, 42.5, 10, 10 };
+    float zOut[] = { 2, 2, 2, 2, 0.5, 5 };
+    float outside[6];
+    grid->getCartesianValues(field, 6, xOut, yOut, zOut, outside);
+    for(int n = 0; ok && (n < 6); n++) {
+        if(outside[n] != -999.)
+            ok = report("outside", n, outside[n], -999.);
+    }
+
+    // Any of the eight surrounding cells missing
+    float xm, ym, zm;
+    grid->setMissing(12, 7, 3, xm, ym, zm);
+    float xNear[] = { xm, xm - 0.5f, xm + 0.5f, xm + 1.5f };
+    float yNear[] = { ym, ym - 1.f, ym + 1.f, ym };
+    float zNear[] = { zm, zm - 0.25f, zm + 0.25f, zm };
+    float near[4];
+    grid->getCartesianValues(field, 4, xNear, yNear, zNear, near);
+    for(int n = 0; ok && (n < 3); n++) {
+        if(near[n] != -999.)
+            ok = report("next to missing", n, near[n], -999.);
+    }
+    if(ok && (fabs(near[3] - linear(xNear[3], yNear[3], zNear[3])) > 1.e-3*(1 + fabs(near[3]))))
+        ok = report("clear of missing", 3, near[3], linear(xNear[3], yNear[3], zNear[3]));
+
+    delete grid;
+    if(ok)
+        std::cout << "getCartesianValues matches the linear field" << std::endl;
+    return ok ? 0 : 1;
+}
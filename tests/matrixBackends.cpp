@@ -0,0 +1,153 @@
+/*
+ *  matrixBackends.cpp
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+// Runs random well conditioned systems through the hand written and the
+// Armadillo Matrix solvers and checks that they agree. Returns non zero
+// on the first mismatch.
+
+#include <math.h>
+#include <iostream>
+#include <random>
+#include "Math/Matrix.h"
+
+static float** newRows(int rows, int cols)
+{
+    float** m = new float*[rows];
+    for(int row = 0; row < rows; row++)
+        m[row] = new float[cols];
+    return m;
+}
+
+static void deleteRows(float** m, int rows)
+{
+    for(int row = 0; row < rows; row++)
+        delete[] m[row];
+    delete[] m;
+}
+
+// The hand written solvers work in single precision, so allow for the
+// rounding of a float normal matrix
+static bool close(double hand, double arma, double scale)
+{
+    return fabs(hand - arma) <= 1.e-3*(fabs(arma) + scale);
+}
+
+static bool report(const char* what, int trial, int index, double hand, double arma)
+{
+    std::cerr << what << " trial " << trial << " index " << index
+              << ": hand written " << hand << ", Armadillo " << arma << std::endl;
+    return false;
+}
+
+static bool checkLls(std::mt19937& random, int trial)
+{
+    std::uniform_int_distribution<int> coeffCount(1, 8);
+    std::uniform_real_distribution<float> value(-1., 1.);
+    std::normal_distribution<float> noise(0., .1);
+
+    // Several times more data than coefficients, like the VTD rings
+    int numCoeff = coeffCount(random);
+    int numData = numCoeff*(4 + trial % 5);
+    float** x = newRows(numCoeff, numData);
+    float* y = new float[numData];
+    for(int i = 0; i < numData; i++) {
+        x[0][i] = 1.;
+        for(int row = 1; row < numCoeff; row++)
+            x[row][i] = value(random);
+        y[i] = noise(random);
+        for(int row = 0; row < numCoeff; row++)
+            y[i] += (row + 1)*x[row][i];
+    }
+
+    float handStDev = 0, armaStDev = 0;
+    float* handCoeff = new float[numCoeff];
+    float* armaCoeff = new float[numCoeff];
+    float* handError = new float[numCoeff];
+    float* armaError = new float[numCoeff];
+    float** AA = newRows(numCoeff, numCoeff);
+    float** BB = newRows(numCoeff, 1);
+
+    bool ok = Matrix::handLls(numCoeff, numData, x, y, handStDev, handCoeff, handError, AA, BB);
+    ok = ok && Matrix::armaLls(numCoeff, numData, x, y, armaStDev, armaCoeff, armaError, AA);
+    if(!ok)
+        std::cerr << "lls trial " << trial << " failed to solve" << std::endl;
+    for(int row = 0; ok && (row < numCoeff); row++) {
+        if(!close(handCoeff[row], armaCoeff[row], 1.))
+            ok = report("lls coeff", trial, row, handCoeff[row], armaCoeff[row]);
+        else if(!close(handError[row], armaError[row], armaStDev))
+            ok = report("lls stError", trial, row, handError[row], armaError[row]);
+    }
+    if(ok && !close(handStDev, armaStDev, .01))
+        ok = report("lls stDeviation", trial, 0, handStDev, armaStDev);
+
+    deleteRows(x, numCoeff);
+    deleteRows(AA, numCoeff);
+    deleteRows(BB, numCoeff);
+    delete[] y;
+    delete[] handCoeff;
+    delete[] armaCoeff;
+    delete[] handError;
+    delete[] armaError;
+    return ok;
+}
+
+static bool checkGaussJordan(std::mt19937& random, int trial)
+{
+    std::uniform_int_distribution<int> size(1, 10);
+    std::uniform_real_distribution<float> value(-1., 1.);
+
+    // Diagonally dominant, so well conditioned
+    int n = size(random);
+    int m = 1 + trial % 3;
+    float** handA = newRows(n, n);
+    float** armaA = newRows(n, n);
+    float** handB = newRows(n, m);
+    float** armaB = newRows(n, m);
+    for(int row = 0; row < n; row++) {
+        for(int col = 0; col < n; col++)
+            handA[row][col] = armaA[row][col] = value(random);
+        handA[row][row] = armaA[row][row] = handA[row][row] + n;
+        for(int col = 0; col < m; col++)
+            handB[row][col] = armaB[row][col] = value(random);
+    }
+
+    bool ok = Matrix::handGaussJordan(handA, handB, n, m);
+    ok = ok && Matrix::armaGaussJordan(armaA, armaB, n, m);
+    if(!ok)
+        std::cerr << "gaussJordan trial " << trial << " failed to solve" << std::endl;
+    for(int row = 0; ok && (row < n); row++) {
+        for(int col = 0; ok && (col < m); col++) {
+            if(!close(handB[row][col], armaB[row][col], 1./n))
+                ok = report("gaussJordan solution", trial, row, handB[row][col], armaB[row][col]);
+        }
+        for(int col = 0; ok && (col < n); col++) {
+            if(!close(handA[row][col], armaA[row][col], 1./n))
+                ok = report("gaussJordan inverse", trial, row, handA[row][col], armaA[row][col]);
+        }
+    }
+
+    deleteRows(handA, n);
+    deleteRows(armaA, n);
+    deleteRows(handB, n);
+    deleteRows(armaB, n);
+    return ok;
+}
+
+int main()
+{
+    // Fixed seed so a failure can be reproduced
+    std::mt19937 random(20260101);
+    int numTrials = 500;
+    for(int trial = 0; trial < numTrials; trial++) {
+        if(!checkLls(random, trial) || !checkGaussJordan(random, trial))
+            return 1;
+    }
+    std::cout << numTrials << " lls and gaussJordan systems agree" << std::endl;
+    return 0;
+}
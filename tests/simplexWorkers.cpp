@@ -0,0 +1,139 @@
+/*
+ *  simplexWorkers.cpp
+ *  vortrac
+ *
+ *  Copyright 2026 University Corporation for Atmospheric Research.
+ *  All rights reserved.
+ *
+ */
+
+// Runs SimplexThread::findCenter on a synthetic vortex with one worker and
+// with several, and checks that the archived SimplexData is identical. The
+// configuration comes from the file given on the command line. Returns
+// non zero on the first difference.
+
+#include <math.h>
+#include <stdlib.h>
+#include <iostream>
+#include "Config/Configuration.h"
+#include "DataObjects/SimplexList.h"
+#include "Threads/SimplexThread.h"
+
+// A Rankine vortex 3 km east and 2 km south of the first guess, seen by a
+// radar at the grid origin, with noise and 10% missing cells
+class VortexGrid : public GriddedData
+{
+public:
+    void fill(float xCenter, float yCenter)
+    {
+        iDim = 120; jDim = 120; kDim = 6;
+        iGridsp = 1.0; jGridsp = 1.0; kGridsp = 1.0;
+        xmin = -20; ymin = -20; zmin = 0;
+        xmax = xmin + iDim*iGridsp; ymax = ymin + jDim*jGridsp; zmax = zmin + kDim*kGridsp;
+        originLat = 25; originLon = -80;
+
+        srand(7);
+        for(int i = 0; i < iDim; i++) {
+            for(int j = 0; j < jDim; j++) {
+                for(int k = 0; k < kDim; k++) {
+                    float x = xmin + i*iGridsp;
+                    float y = ymin + j*jGridsp;
+                    float dx = x - xCenter;
+                    float dy = y - yCenter;
+                    float r = sqrt(dx*dx + dy*dy) + 1.e-3;
+                    float rmw = 15;
+                    float vtMax = 50 + 2*k;
+                    float vt = (r < rmw) ? vtMax*r/rmw : vtMax*rmw/r;
+                    float u = -vt*dy/r;
+                    float v = vt*dx/r;
+                    float range = sqrt(x*x + y*y) + 1.e-3;
+                    float noise = ((rand() % 1000)/1000.f - .5f)*3;
+                    float vr = (u*x + v*y)/range + noise;
+                    dataGrid[1][i][j][k] = (rand() % 10 == 0) ? -999.f : vr;
+                }
+            }
+        }
+    }
+};
+
+static SimplexData search(Configuration& config, GriddedData* grid,
+                          float latGuess, float lonGuess, const QString& threads)
+{
+    config.setParam(config.getConfig("center"), "threads", threads);
+    SimplexThread simplex;
+    simplex.initParam(&config, grid, latGuess, lonGuess);
+    SimplexList list;
+    simplex.findCenter(&list);
+    return list.last();
+}
+
+static bool same(const char* what, int level, int ring, float serial, float parallel)
+{
+    // Bit for bit, so NaN only matches NaN
+    if((serial == parallel) || (std::isnan(serial) && std::isnan(parallel)))
+        return true;
+    std::cerr << what << " level " << level << " ring " << ring << ": 1 worker "
+              << serial << ", several " << parallel << std::endl;
+    return false;
+}
+
+static bool compare(const SimplexData& serial, const SimplexData& parallel)
+{
+    bool ok = true;
+    for(int l = 0; l < serial.getNumLevels(); l++) {
+        for(int r = 0; r < serial.getNumRadii(); r++) {
+            ok = ok && same("mean x", l, r, serial.getMeanX(l, r), parallel.getMeanX(l, r));
+            ok = ok && same("mean y", l, r, serial.getMeanY(l, r), parallel.getMeanY(l, r));
+            ok = ok && same("max vt", l, r, serial.getMaxVT(l, r), parallel.getMaxVT(l, r));
+            ok = ok && same("center std dev", l, r, serial.getCenterStdDev(l, r),
+                            parallel.getCenterStdDev(l, r));
+            ok = ok && same("vt uncertainty", l, r, serial.getVTUncertainty(l, r),
+                            parallel.getVTUncertainty(l, r));
+            ok = ok && same("converging centers", l, r, serial.getNumConvergingCenters(l, r),
+                            parallel.getNumConvergingCenters(l, r));
+            for(int c = 0; ok && (c < serial.getNumPointsUsed()); c++) {
+                Center a = serial.getCenter(l, r, c);
+                Center b = parallel.getCenter(l, r, c);
+                ok = same("center x", l, r, a.getX(), b.getX())
+                    && same("center y", l, r, a.getY(), b.getY())
+                    && same("center max vt", l, r, a.getMaxVT(), b.getMaxVT());
+            }
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc < 2) {
+        std::cerr << "usage: simplexWorkers config.xml" << std::endl;
+        return 2;
+    }
+    Configuration config(0, QString(argv[1]));
+    QDomElement center = config.getConfig("center");
+
+    float originLat = 25;
+    float originLon = -80;
+    float latGuess = 25.05;
+    float lonGuess = -79.95;
+    CartesianPoint guess = GriddedData::getCartesianPoint(&originLat, &originLon,
+                                                          &latGuess, &lonGuess);
+    VortexGrid* grid = new VortexGrid;
+    grid->fill(guess.x + 3, guess.y - 2);
+
+    // Raw and resampled rings take different extraction paths
+    const char* azimuthSamples[] = { "0", "32" };
+    bool ok = true;
+    for(int n = 0; ok && (n < 2); n++) {
+        config.setParam(center, "azimuthsamples", azimuthSamples[n]);
+        SimplexData serial = search(config, grid, latGuess, lonGuess, "1");
+        SimplexData parallel = search(config, grid, latGuess, lonGuess, "4");
+        ok = compare(serial, parallel);
+        if(!ok)
+            std::cerr << "azimuthsamples " << azimuthSamples[n] << " differs" << std::endl;
+    }
+    delete grid;
+    if(ok)
+        std::cout << "1 and 4 workers archive the same SimplexData" << std::endl;
+    return ok ? 0 : 1;
+}